@@ -6,6 +6,7 @@
 #define BUFFERUNIT_H_
 
 #include <vector>
+#include <memory>
 #include "InputParameter.h"
 #include "Technology.h"
 #include "MemCell.h"
@@ -24,10 +25,10 @@ public:
                                 /* buType: 0 - DFF, 1 - register file, 2 - SRAM */
 
     /* Components */
-    DFF *outDff;
-    DFF *inDff;
-    Buffer *outBuffer;
-    Buffer *inBuffer;
+    std::unique_ptr<DFF> outDff;
+    std::unique_ptr<DFF> inDff;
+    std::unique_ptr<Buffer> outBuffer;
+    std::unique_ptr<Buffer> inBuffer;
 
     /* Functions */
     void Initialize(double _unitWireRes, double _clkFreq);
@@ -42,6 +43,7 @@ public:
     bool initialized;   /* Initialization flag */
     int buType; /* buType: 0 - DFF, 1 - register file, 2 - SRAM */
     int outBUSize, inBUSize, outBUCoreBW, inBUCoreBW, numOutBUCore, numInBUCore;
+    int numBank; /* 2 for ping-pong buffer of buType 1/2 (each bank holds outBUSize/inBUSize), 1 otherwise */
     double clkFreq;
 
     /* Performance */
@@ -6,6 +6,7 @@
 #define DIGITALELEMENTS_H_
 
 #include <vector>
+#include <memory>
 #include "InputParameter.h"
 #include "Technology.h"
 #include "AdderTree.h"
@@ -24,9 +25,9 @@ public:
     const vector<double> designDE; // AdderTree - numUnit, numAdderBit, numAdd / reLU - numUnit, numBit / max - numUnit, numBit, window
 
     /* Components */
-    AdderTree *adderTree;
-    BitShifter *reLu;
-    MaxPooling *maxPooling;
+    unique_ptr<AdderTree> adderTree;
+    unique_ptr<BitShifter> reLu;
+    unique_ptr<MaxPooling> maxPooling;
 
     /* Functions */
     void Initialize(bool _fixedDataFlow, double _clkFreq);
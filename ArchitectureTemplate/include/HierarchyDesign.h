@@ -0,0 +1,48 @@
+/*********************************************************************************************
+* Definition of the Hierarchy Design (owner of the hierarchy objects of a single design)
+*********************************************************************************************/
+
+#ifndef HIERARCHYDESIGN_H_
+#define HIERARCHYDESIGN_H_
+
+#include <vector>
+#include <memory>
+#include "InputParameter.h"
+#include "Technology.h"
+#include "MemCell.h"
+#include "HierarchyRoot.h"
+#include "HierarchyObject.h"
+
+using namespace std;
+
+class HierarchyDesign {
+//private:
+public:
+    HierarchyDesign(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell,
+                    const HierarchyRoot* _hRoot, const vector<vector<double>> _designArch);
+    virtual ~HierarchyDesign() {}
+    InputParameter& inputParameter;
+    Technology& tech;
+    MemCell& cell;
+    const HierarchyRoot *hRoot; // root is not owned, so that designs with the same CIM array can share it
+    const vector<vector<double>> designArch;
+
+    /* Functions */
+    void Initialize(double _clkFreq); // build & initialize hObjects from hlevel 1 to top
+    // reuse hlevel 1 to _numShared of an initialized design with the same root & designArch up to that level
+    void Initialize(double _clkFreq, const shared_ptr<const HierarchyDesign> &_baseDesign, int _numShared);
+    HierarchyObject* GetTop() const;
+
+    /* Properties */
+    bool initialized;
+    int numHierarchy;
+    int numShared;  // objects of baseDesign in hObjectVector (hlevel 1 -> numShared)
+
+    /* Hierarchy Objects (hlevel 1 -> top) */
+    vector<unique_ptr<HierarchyObject>> hObjects; // owner of the objects
+    vector<HierarchyObject*> hObjectVector; // non-owning view for the scheduler/evaluator
+    shared_ptr<const HierarchyDesign> baseDesign; // keeps the shared objects alive
+
+}; /* class HierarchyDesign */
+
+#endif /* HIERARCHYDESIGN_H_ */
@@ -6,6 +6,7 @@
 #define HIERARCHYOBJECT_H_
 
 #include <vector>
+#include <memory>
 #include "InputParameter.h"
 #include "Technology.h"
 #include "MemCell.h"
@@ -39,9 +40,9 @@ public:
     const int lenDesignBU = 7;
 
     /* Components */
-    DigitalElements *digitalElements;
-    InterConnect *interConnect;
-    BufferUnit *bufferUnit;
+    unique_ptr<DigitalElements> digitalElements;
+    unique_ptr<InterConnect> interConnect;
+    unique_ptr<BufferUnit> bufferUnit;
 
     /* Functions */
     void Initialize(double _clkFreq);
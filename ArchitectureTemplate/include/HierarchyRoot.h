@@ -6,6 +6,9 @@
 #define HIERARCHYROOT_H_
 
 #include <vector>
+#include <memory>
+#include <map>
+#include <tuple>
 #include "InputParameter.h"
 #include "Technology.h"
 #include "MemCell.h"
@@ -23,8 +26,12 @@ public:
     MemCell& cell;
     int hlevel = 0; // hlevel is 0
 
+    /* key of the evaluation cache: weightMatrixRow, weightMatrixCol, numBitInput, numCellPerSynapse,
+       layerIdx (-1: w/o activity profile) */
+    typedef tuple<double, double, double, double, int> EvalKey;
+
     /* Components */
-    CIMArray * cimArray;
+    unique_ptr<CIMArray> cimArray;
 
     /* Functions */
     void Initialize();
@@ -33,11 +40,14 @@ public:
     void CalculateLatency(bool CalculateFreq, double weightMatrixRow, double weightMatrixCol, 
                         double numBitInput, double numCellPerSynapse, double numRead, double *clkPeriod);
     void CalculatePower(vector<double> infoReadCIM);
+    EvalKey GetEvalKey(const vector<double> &infoReadCIM);
     void CalculatePower(double weightMatrixRow, double weightMatrixCol, 
                         double numBitInput, double numCellPerSynapse, double numRead);
     void CalculateLeakage();
     void PrintProperty();
     void GetColumnResistance();
+    // scaleOn/Off: device variation of Ron/Roff (Monte Carlo)
+    double GetColumnResistance(double activeRatio, double scaleOn = 1, double scaleOff = 1);
 
     /* properties */
     bool initialized;   /* Initialization flag */
@@ -53,6 +63,14 @@ public:
     vector<double> weightLevelRatioVector; /* ratio of each level (low -> high)*/
     double columnRes;
 
+    /* input activity profile (param->activityProfile) */
+    vector<double> activeRatioVector;   /* distinct input active ratios of the profile */
+    vector<double> columnResVector;     /* column resistance of each distinct ratio */
+    vector<vector<int>> layerActivityVector; /* ratio index of each bitplane (LSB first) of each layer */
+
+    /* evaluation cache (latency/energy per read) */
+    map<EvalKey, vector<double>> latencyCache, energyCache;
+
     /* Performance */
     vector<double> areaVector; /* Vector (total, array, ADC, accum, dummy(buffer, ic, other)) */
     vector<double> latencyVector; /* Vector (total, array (include ADC), accum, dummy(buffer, ic, other)) */
@@ -6,6 +6,7 @@
 #define INTERCONNECT_H_
 
 #include <vector>
+#include <memory>
 #include "InputParameter.h"
 #include "Technology.h"
 #include "Bus.h"
@@ -25,19 +26,21 @@ public:
     const vector<double> designIC; // delaytolerance, outType, outBusWidth, inType, inBusWidth (delay, 2(2D Mesh), flit, port, -)
 
     /* Components */
-    Bus             *outBus;
-    Bus             *inBus;
-    LinearArray     *inLinear;
-    LinearArray     *outLinear;
-    Mesh            *mesh;
-    HBus            *outHBus;
-    HBus            *inHBus;
+    unique_ptr<Bus>         outBus;
+    unique_ptr<Bus>         inBus;
+    unique_ptr<LinearArray> inLinear;
+    unique_ptr<LinearArray> outLinear;
+    unique_ptr<Mesh>        mesh;
+    unique_ptr<HBus>        outHBus;
+    unique_ptr<HBus>        inHBus;
 
     /* Functions */
     void Initialize(int numRow, int numCol, double _unitHeight, double _unitWidth, int inBUSize, double _clkFreq);
     void CalculateArea();
     /*inforReadIC: numOutRead, numInRead, x_init, y_init, x_end, y_end*/
     void CalculateLatency(const vector<double> infoReadIC); 
+    void CalculateFlowLatency(); // event-driven mesh NoC, after all IC records of the scheduling step
+    void CalculateOverlap(double computeLatency); // input feeding overlapped with the computation
     void CalculatePower(const vector<double> inforReadIC);
     void CalculateLeakage();
     void PrintProperty(const char* str);
@@ -56,7 +59,11 @@ public:
     double readLatency;
     double leakage;
     double readDynamicEnergy;
-    double overlapLatency, inputCounter, prevInputCounter; // for input latency overlap
+    double overlapLatency, inputCounter, prevReadLatency; // for input latency overlap
+    double firstInputLatency;   // first input transfer after a reset (fills the subObjects, not overlapped)
+    double meshFlowLatency; // latency of the mesh flows included in readLatency (event-driven mesh NoC)
+    vector<int> meshOutCol; // next col of the output flow in each row (event-driven mesh NoC)
+    int meshInRow;          // row reached by the previous input flow (event-driven mesh NoC)
 
 }; /* class InterConnect */
 
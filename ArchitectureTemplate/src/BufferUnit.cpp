@@ -3,6 +3,9 @@
 #include "constant.h"
 #include "formula.h"
 #include "BufferUnit.h"
+#include "Param.h"
+
+extern Param *param;
 
 
 BufferUnit::BufferUnit(const InputParameter& _inputParameter, const Technology& _tech, const MemCell& _cell, const vector<double> _designBU):
@@ -17,14 +20,14 @@ inputParameter(_inputParameter), tech(_tech), cell(_cell), designBU(_designBU) {
     numInBUCore = (int)designBU[6];
 
     if ( buType == 0 ) {
-        outDff = new DFF(inputParameter, tech);
+        outDff.reset(new DFF(inputParameter, tech));
         if ( inBUSize > 0 ) {
-            inDff = new DFF(inputParameter, tech);
+            inDff.reset(new DFF(inputParameter, tech));
         }
     } else {
-        outBuffer = new Buffer(inputParameter, tech, cell);
+        outBuffer.reset(new Buffer(inputParameter, tech, cell));
         if ( inBUSize > 0 ) {
-            inBuffer = new Buffer(inputParameter, tech, cell);
+            inBuffer.reset(new Buffer(inputParameter, tech, cell));
         }
     }
     // not initialized
@@ -37,6 +40,9 @@ void BufferUnit::Initialize(double _unitWireRes, double _clkFreq) {
 
     // set clock frequency
     clkFreq = _clkFreq;
+    // ping-pong buffer: a second bank of the same size is written while the other is read
+    // (register file/SRAM only, the DFF latency has no write part to hide)
+    numBank = ( (param->pingPongBuffer == 1) && (buType != 0) )? 2 : 1;
  
     // initialize buffer
     if ( buType == 0 ) {
@@ -87,6 +93,7 @@ void BufferUnit::CalculateArea(double newHeight, double newWidth) {
         //printf("%-20s %10.4e\n", "newWidth", newWidth);
         //printf("%-20s %10.4e\n", "area", outBuffer->area);
     }
+    area *= numBank;
 
 }
 
@@ -107,13 +114,22 @@ void BufferUnit::CalculateLatency(const vector<double> infoReadBU) {
                                 ceil(infoReadBU[0])/*numOutRead*/,  // ceil for access counting
                                 outBuffer->interface_width, 
                                 ceil(infoReadBU[1])/*numOutWrite*/);
-        latency =  ( outBuffer->readLatency + outBuffer->writeLatency ) / infoReadBU[2];
+        // ping-pong buffer: writes of the next tile are hidden behind reads of the current tile
+        if ( numBank > 1 ) {
+            latency = MAX( outBuffer->readLatency, outBuffer->writeLatency ) / infoReadBU[2];
+        } else {
+            latency =  ( outBuffer->readLatency + outBuffer->writeLatency ) / infoReadBU[2];
+        }
         if ( inBUSize > 0 ) {
             inBuffer->CalculateLatency(inBuffer->interface_width, 
                                     ceil(infoReadBU[3])/*numInRead*/,  // ceil for access counting
                                     inBuffer->interface_width, 
                                     ceil(infoReadBU[4])/*numInWrite*/);
-            latency +=  ( inBuffer->readLatency + inBuffer->writeLatency ) / infoReadBU[5];
+            if ( numBank > 1 ) {
+                latency += MAX( inBuffer->readLatency, inBuffer->writeLatency ) / infoReadBU[5];
+            } else {
+                latency +=  ( inBuffer->readLatency + inBuffer->writeLatency ) / infoReadBU[5];
+            }
         }
         latency = ceil(latency); // ceil for cycle counting 
         ////// DICE debugging 
@@ -178,6 +194,7 @@ void BufferUnit::CalculatePower(const vector<double> infoReadBU) {
         //    printf("%-20s %15.1f\n", "inBuffer numOutWrite", infoReadBU[4]);
         //}
     }
+    leakage *= numBank;
 
 }
 
@@ -201,6 +218,7 @@ void BufferUnit::CalculateLeakage() {
             leakage += inBuffer->leakage;
         }
     }
+    leakage *= numBank;
 
 }
 
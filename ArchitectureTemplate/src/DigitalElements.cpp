@@ -11,21 +11,21 @@ inputParameter(_inputParameter), tech(_tech), designDE(_designDE) {
         placeAdderTree = false;
     } else {
         placeAdderTree = true;
-        adderTree = new AdderTree(inputParameter, tech);
+        adderTree.reset(new AdderTree(inputParameter, tech));
     }
     // place reLu
     if (designDE[3] < 1) {
         placeReLu = false;
     } else {
         placeReLu = true;
-        reLu = new BitShifter(inputParameter, tech);
+        reLu.reset(new BitShifter(inputParameter, tech));
     }
     // place maxPooling 
     if (designDE[5] < 1) {
         placeMaxPooling = false;
     } else {
         placeMaxPooling = true;
-        maxPooling = new MaxPooling(inputParameter, tech);
+        maxPooling.reset(new MaxPooling(inputParameter, tech));
     }
     // not initialized
     initialized = false;
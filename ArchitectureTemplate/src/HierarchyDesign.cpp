@@ -0,0 +1,59 @@
+#include <iostream>
+#include <algorithm>
+#include "HierarchyDesign.h"
+
+HierarchyDesign::HierarchyDesign(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell,
+                                 const HierarchyRoot* _hRoot, const vector<vector<double>> _designArch):
+inputParameter(_inputParameter), tech(_tech), cell(_cell), hRoot(_hRoot), designArch(_designArch) {
+
+    numHierarchy = designArch.size();
+    numShared = 0;
+
+    // not initialized
+    initialized = false;
+}
+
+/* Initialize hierarchy objects */
+/* Objects are built bottom-up, as each object reads the properties of its initialized subObject */
+void HierarchyDesign::Initialize(double _clkFreq) {
+    Initialize(_clkFreq, nullptr, 0);
+}
+
+/* Objects of the lower levels only depend on the root & designArch up to their level,
+ * so a design sharing that prefix with an initialized design takes them as they are */
+void HierarchyDesign::Initialize(double _clkFreq, const shared_ptr<const HierarchyDesign> &_baseDesign, int _numShared) {
+
+    if ( initialized ) {
+        cout << "[HierarchyDesign] Warning: Already initialized!" << endl;
+        hObjectVector.clear();
+        hObjects.clear();
+        baseDesign.reset();
+    }
+
+    numShared = ( _baseDesign )? min(_numShared, min(numHierarchy, _baseDesign->numHierarchy)) : 0;
+    if ( numShared > 0 ) {
+        baseDesign = _baseDesign;
+    }
+    const HierarchyObject *prevObject = NULL;
+    for (int h=1; h < (numHierarchy + 1); h++) {
+        if ( h <= numShared ) {
+            HierarchyObject *hObject = baseDesign->hObjectVector[h-1];
+            hObjectVector.push_back(hObject);
+            prevObject = hObject;
+            continue;
+        }
+        printf("Initialize %d-level object\n",h);
+        HierarchyObject *hObject = new HierarchyObject(inputParameter, tech, cell, h, hRoot, prevObject, designArch[h-1]);
+        hObjects.push_back(unique_ptr<HierarchyObject>(hObject));
+        hObject->Initialize(_clkFreq);
+
+        hObjectVector.push_back(hObject);
+        prevObject = hObject;
+    }
+
+    initialized = true;
+}
+
+HierarchyObject* HierarchyDesign::GetTop() const {
+    return hObjectVector.back();
+}
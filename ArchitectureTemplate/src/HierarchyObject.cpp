@@ -28,9 +28,9 @@ designObject(_designObject){
     designIC.assign(designObject.begin() + 10, designObject.begin() + 15);
     designBU.assign(designObject.begin() + 15, designObject.begin() + 22);
 
-    digitalElements = new DigitalElements(inputParameter, tech, designDE);
-    interConnect = new InterConnect(inputParameter, tech, designIC);
-    bufferUnit = new BufferUnit(inputParameter, tech, cell/*dummy*/, designBU);
+    digitalElements.reset(new DigitalElements(inputParameter, tech, designDE));
+    interConnect.reset(new InterConnect(inputParameter, tech, designIC));
+    bufferUnit.reset(new BufferUnit(inputParameter, tech, cell/*dummy*/, designBU));
 
     // get row/col count info
     if ( hlevel == 1 ) {
@@ -189,12 +189,15 @@ void HierarchyObject::CalculateLatency(const vector<double> infoRead, const vect
     // sub latency information (sync, cycle counting)
     digitalElements->CalculateLatency(infoReadDE);
     interConnect->CalculateLatency(infoReadIC);
+    interConnect->CalculateFlowLatency(); // IC records of the object are all given
+    interConnect->CalculateOverlap(subLatencyVector[0]);
     bufferUnit->CalculateLatency(infoReadBU);
+    double icLatency = interConnect->readLatency - interConnect->overlapLatency; // exposed ic latency
 
     double latency = subLatencyVector[0] +
                     digitalElements->latencyVector[0] +
                     bufferUnit->latency +
-                    interConnect->readLatency;
+                    icLatency;
 
     // clear vector before update
     latencyVector.clear();
@@ -205,7 +208,7 @@ void HierarchyObject::CalculateLatency(const vector<double> infoRead, const vect
     latencyVector.push_back(subLatencyVector[1]); // array
     latencyVector.push_back(subLatencyVector[2] + digitalElements->latencyVector[1]); // accum
     latencyVector.push_back(subLatencyVector[3] + bufferUnit->latency); // buffer
-    latencyVector.push_back(subLatencyVector[4] + interConnect->readLatency); // ic
+    latencyVector.push_back(subLatencyVector[4] + icLatency); // ic
     latencyVector.push_back(subLatencyVector[5] + 
                             digitalElements->latencyVector[2] + digitalElements->latencyVector[3]); // other digital
 
@@ -214,7 +217,7 @@ void HierarchyObject::CalculateLatency(const vector<double> infoRead, const vect
     latencyVector2.push_back(subLatencyVector[0]); // subObject
     latencyVector2.push_back(digitalElements->latencyVector[1]); // accum
     latencyVector2.push_back(bufferUnit->latency); // buffer
-    latencyVector2.push_back(interConnect->readLatency); //ic
+    latencyVector2.push_back(icLatency); //ic
     latencyVector2.push_back(digitalElements->latencyVector[2] + digitalElements->latencyVector[3]); // other digital
 
     //// DICE: debugging
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include "constant.h"
 #include "formula.h"
 #include "HierarchyRoot.h"
@@ -14,12 +15,12 @@ inputParameter(_inputParameter), tech(_tech), cell(_cell) {
 		case 2:	    cell.memCellType = Type::RRAM; break;
 		case 1:	    cell.memCellType = Type::SRAM; break;
 		case -1:	break;
-		default:	exit(-1);
+		default:	cerr << "[Error] invalid memcelltype" << endl; exit(-1);
 	}
 	switch(param->accesstype) {
 		case 1:	    cell.accessType = CMOS_access;  break;
 		case -1:	break;
-		default:	exit(-1);
+		default:	cerr << "[Error] invalid accesstype" << endl; exit(-1);
 	}				
 					
 	switch(param->transistortype) {
@@ -27,14 +28,14 @@ inputParameter(_inputParameter), tech(_tech), cell(_cell) {
 		case 2:	    inputParameter.transistorType = FET_2D;        break;
 		case 1:	    inputParameter.transistorType = conventional;  break;
 		case -1:	break;
-		default:	exit(-1);
+		default:	cerr << "[Error] invalid transistortype" << endl; exit(-1);
 	}
 	
 	switch(param->deviceroadmap) {
 		case 2:	    inputParameter.deviceRoadmap = LSTP;  break;
 		case 1:	    inputParameter.deviceRoadmap = HP;    break;
 		case -1:	break;
-		default:	exit(-1);
+		default:	cerr << "[Error] invalid deviceroadmap" << endl; exit(-1);
 	}
 	inputParameter.temperature = param->temp;   // Temperature (K)
 	inputParameter.processNode = param->technode;    // Technology node
@@ -62,7 +63,7 @@ inputParameter(_inputParameter), tech(_tech), cell(_cell) {
 		cell.widthInFeatureSize = (cell.accessType==CMOS_access)? param->widthInFeatureSize1T1R : param->widthInFeatureSizeCrossbar;            // Cell width in feature size
 	} 
 
-	cimArray = new CIMArray(inputParameter, tech, cell);
+	cimArray.reset(new CIMArray(inputParameter, tech, cell));
 		
 	/* Create CIMArray object initialization */
 	cimArray->XNORparallelMode = param->XNORparallelMode;               
@@ -72,7 +73,7 @@ inputParameter(_inputParameter), tech(_tech), cell(_cell) {
 	cimArray->conventionalParallel = param->conventionalParallel;                  
 	cimArray->conventionalSequential = param->conventionalSequential;                 
 	cimArray->numRow = param->numRowCIMArray;
-	cimArray->numCol = param->numRowCIMArray;
+	cimArray->numCol = param->numColCIMArray;
 	cimArray->levelOutput = param->levelOutput;
 	cimArray->numColMuxed = param->numColMuxed;               // How many columns share 1 read circuit (for neuro mode with analog RRAM) or 1 S/A (for memory mode or neuro mode with digital RRAM)
     cimArray->clkFreq = param->clkFreq;                       // Clock frequency
@@ -103,8 +104,7 @@ inputParameter(_inputParameter), tech(_tech), cell(_cell) {
     maxConductance = param->maxConductance;                    // max conductance level of the memory cell
     minConductance = param->minConductance;                    // min conductance level of the memroy cell
 
-    //** NOTE: we should support bitplane-wise ratio in the future **//
-    inputActiveRatio = param->inputActiveRatio;                 // ratio of active value in each bitplane of input
+    inputActiveRatio = param->inputActiveRatio;                 // ratio of active value in each bitplane of input (w/o profile)
     weightLevelRatioVector = param->weightLevelRatioVector;     // ratio of each weight-cell level
 
 	/*** initialize modules ***/
@@ -131,6 +131,32 @@ void HierarchyRoot::Initialize() {
 
 void HierarchyRoot::GetColumnResistance() {
 
+    columnRes = GetColumnResistance(inputActiveRatio);
+
+    // bitplane-wise ratio of each layer: column resistance is precomputed for each distinct ratio
+    activeRatioVector.clear();
+    columnResVector.clear();
+    layerActivityVector.clear();
+    latencyCache.clear();
+    energyCache.clear();
+    for ( auto &layerProfile : param->activityProfile ) {
+        vector<int> layerActivity;
+        for ( int bit=0; bit < param->numBitInput; bit++ ) {
+            double ratio = layerProfile[MIN(bit, (int)layerProfile.size()-1)];
+            int ratioIdx = find(activeRatioVector.begin(), activeRatioVector.end(), ratio) - activeRatioVector.begin();
+            if ( ratioIdx == activeRatioVector.size() ) {
+                activeRatioVector.push_back(ratio);
+                columnResVector.push_back(GetColumnResistance(ratio));
+            }
+            layerActivity.push_back(ratioIdx);
+        }
+        layerActivityVector.push_back(layerActivity);
+    }
+
+}
+
+double HierarchyRoot::GetColumnResistance(double activeRatio, double scaleOn, double scaleOff) {
+
     int cellRange = pow(2, param->cellBit);
     double cellG, cellR;
     double columnG = 0;
@@ -139,21 +165,21 @@ void HierarchyRoot::GetColumnResistance() {
     if (cell.memCellType == Type::RRAM) {
         if (cell.accessType == CMOS_access) {
             for (int i=0; i < cellRange; i++ ) {
-                cellG = i / (cellRange - 1) * (maxConductance - minConductance) + minConductance;
+                cellG = i / (cellRange - 1) * (maxConductance / scaleOn - minConductance / scaleOff) + minConductance / scaleOff;
                 cellR = (double) 1.0 / cellG + cell.resistanceAccess;
-                columnG += (double) 1.0 / cellR * (numRow * inputActiveRatio * weightLevelRatioVector[i]);
+                columnG += (double) 1.0 / cellR * (numRow * activeRatio * weightLevelRatioVector[i]);
             }
         } else{
             cerr << "[Error] We support CMOS_access for RRAM only." << endl;
         }
     } else if (cell.memCellType == Type::SRAM) {
-                cellR = (double) (cimArray->resCellAccess + param->wireResistanceCol);
-                columnG += (double) 1.0 / cellR * numRow * inputActiveRatio;
+                cellR = (double) (cimArray->resCellAccess * scaleOn + param->wireResistanceCol);
+                columnG += (double) 1.0 / cellR * numRow * activeRatio;
     } else {
         cerr << "[Error] We support RRAM & SRAM memory cell only, not memCellType: " << cell.memCellType << endl;
     } 
    
-    columnRes = 1.0 / columnG;
+    return 1.0 / columnG;
 
 }
 
@@ -181,6 +207,15 @@ void HierarchyRoot::CalculateArea() {
 
 }
 
+/* Key of the evaluation cache for the infoRead */
+HierarchyRoot::EvalKey HierarchyRoot::GetEvalKey(const vector<double> &infoReadCIM) {
+    int layerIdx = ( infoReadCIM.size() > 5 )? (int)infoReadCIM[5] : -1;
+    if ( layerIdx >= (int)layerActivityVector.size() ) { // layer w/o activity profile
+        layerIdx = -1;
+    }
+    return make_tuple(infoReadCIM[0], infoReadCIM[1], infoReadCIM[2], infoReadCIM[3], layerIdx);
+}
+
 /* Calculate Latency of hierarchy root - CIM array */
 void HierarchyRoot::CalculateLatency(vector<double> infoReadCIM) {
     double weightMatrixRow = infoReadCIM[0];
@@ -189,11 +224,21 @@ void HierarchyRoot::CalculateLatency(vector<double> infoReadCIM) {
     double numCellPerSynapse = infoReadCIM[3];
     double numRead = ceil(infoReadCIM[4]);
 
-    double dummy;
+    // latency per read is evaluated once for each key
+    EvalKey key = GetEvalKey(infoReadCIM);
+    auto cache = latencyCache.find(key);
+    if ( cache == latencyCache.end() ) {
+        double dummy;
+        CalculateLatency(false, weightMatrixRow, weightMatrixCol,
+                        numBitInput, numCellPerSynapse,
+                        1, &dummy);
+        cache = latencyCache.insert(make_pair(key, latencyVector)).first;
+    }
 
-    CalculateLatency(false, weightMatrixRow, weightMatrixCol,
-                    numBitInput, numCellPerSynapse,
-                    numRead, &dummy);
+    latencyVector.clear();
+    for ( auto latency : cache->second ) {
+        latencyVector.push_back(latency * numRead);
+    }
 
 }
 
@@ -235,9 +280,46 @@ void HierarchyRoot::CalculatePower(vector<double> infoReadCIM) {
     double numCellPerSynapse = infoReadCIM[3];
     double numRead = ceil(infoReadCIM[4]);
 
-    CalculatePower(weightMatrixRow, weightMatrixCol,
-                    numBitInput, numCellPerSynapse,
-                    numRead);
+    // energy per read is evaluated once for each key
+    EvalKey key = GetEvalKey(infoReadCIM);
+    auto cache = energyCache.find(key);
+    if ( cache == energyCache.end() ) {
+        int layerIdx = get<4>(key);
+        if ( layerIdx < 0 ) {
+            CalculatePower(weightMatrixRow, weightMatrixCol,
+                            numBitInput, numCellPerSynapse,
+                            1);
+        } else {
+            // bitplane-wise input active ratio: the bitplanes of the layer (LSB first) are grouped by the ratio,
+            // and CIMArray is evaluated once for each distinct ratio
+            vector<int> numBitplane(activeRatioVector.size(), 0);
+            const vector<int> &layerActivity = layerActivityVector[layerIdx];
+            for ( int bit=0; bit < (int)numBitInput; bit++ ) {
+                numBitplane[layerActivity[MIN(bit, (int)layerActivity.size()-1)]]++;
+            }
+            vector<double> energyVector(4, 0); // total, array, ADC, accum
+            for ( int ratioIdx=0; ratioIdx < numBitplane.size(); ratioIdx++ ) {
+                if ( numBitplane[ratioIdx] == 0 ) { continue; }
+                double colR = columnResVector[ratioIdx] * ( weightMatrixRow / numRow );
+                cimArray->CalculatePower(colR, weightMatrixRow, weightMatrixCol, numBitplane[ratioIdx], activeRatioVector[ratioIdx]);
+                energyVector[0] += cimArray->readDynamicEnergy;
+                energyVector[1] += cimArray->readDynamicEnergyArray + cimArray->readDynamicEnergyOther;
+                energyVector[2] += cimArray->readDynamicEnergyADC;
+                energyVector[3] += cimArray->readDynamicEnergyAccum;
+            }
+            // leakage
+            leakage = cimArray->leakage;
+            // dynamic energy & breakdown (total, array, ADC, accum, buffer, ic, other)
+            readDynamicEnergyVector.assign(energyVector.begin(), energyVector.end());
+            readDynamicEnergyVector.resize(7, 0);
+        }
+        cache = energyCache.insert(make_pair(key, readDynamicEnergyVector)).first;
+    }
+
+    readDynamicEnergyVector.clear();
+    for ( auto energy : cache->second ) {
+        readDynamicEnergyVector.push_back(energy * numRead);
+    }
 
 }
 
@@ -1,7 +1,11 @@
 #include <iostream>
 #include "constant.h"
+#include "DesignError.h"
 #include "formula.h"
 #include "InterConnect.h"
+#include "Param.h"
+
+extern Param *param;
 
 InterConnect::InterConnect(const InputParameter& _inputParameter, const Technology& _tech, const vector<double> _designIC):
 inputParameter(_inputParameter), tech(_tech), designIC(_designIC) {
@@ -15,34 +19,32 @@ inputParameter(_inputParameter), tech(_tech), designIC(_designIC) {
 
     // outBus
     if ( outType == 0 /* Bus */) { 
-        outBus = new Bus(inputParameter, tech);    
+        outBus.reset(new Bus(inputParameter, tech));    
     } else if ( outType == 1 /* LinearArray */) {
-        outLinear = new LinearArray(inputParameter, tech);
+        outLinear.reset(new LinearArray(inputParameter, tech));
     } else if ( outType == 2 /* 2D Mesh */) {
-        mesh = new Mesh(inputParameter, tech);
+        mesh.reset(new Mesh(inputParameter, tech));
         inType = 2; // when outType is 2D Mesh, set inType as 2D Mesh, too.
         flitSize =  (int)outBusWidth; 
         numPort = (int)designIC[3];
         inBusWidth = outBusWidth; // Rx
     } else if ( outType == 3 /* hierarchical Bus */ ) {
-        outHBus = new HBus(inputParameter, tech);
+        outHBus.reset(new HBus(inputParameter, tech));
     } else {
-        cerr << "[InterConnect] Error: outType should be one of [0 (Bus), 1 (Linear), 2 (mesh), 3 (HBus)]!" << endl;
-        exit(-1);
+        throw DesignError("icType", "[InterConnect] outType should be one of [0 (Bus), 1 (Linear), 2 (mesh), 3 (HBus)]!");
     }
 
     // inBus 
     if ( inType == 0 /* Bus */) { 
-        inBus = new Bus(inputParameter, tech);    
+        inBus.reset(new Bus(inputParameter, tech));    
     } else if ( inType == 1 /* LinearArray */) {
-        inLinear = new LinearArray(inputParameter, tech);
+        inLinear.reset(new LinearArray(inputParameter, tech));
     } else if ( inType == 2 /* 2D Mesh */) {
         /* NOTE: in the 2D Mesh case, input & output share a single 'mesh' for communication*/
     } else if ( inType == 3 /* hierarchical Bus */) {
-        inHBus  = new HBus(inputParameter, tech);
+        inHBus.reset(new HBus(inputParameter, tech));
     } else {
-        cerr << "[InterConnect] Error: inType should be one of [0 (Bus), 1 (Linear), 2 (mesh), 3 (HBus)]!" << endl;
-        exit(-1);
+        throw DesignError("icType", "[InterConnect] inType should be one of [0 (Bus), 1 (Linear), 2 (mesh), 3 (HBus)]!");
     }
     inBusMode = HORIZONTAL;
     // not initialized
@@ -89,6 +91,15 @@ void InterConnect::Initialize(int numRow, int numCol, double _unitHeight, double
         //inHBus->Initialize(inBusMode, false, numRow, numCol, delaytolerance, inBusWidth, unitHeight, unitWidth, 1, clkFreq);
     }
 
+    readLatency = 0;
+    overlapLatency = 0;
+    inputCounter = 0;
+    firstInputLatency = -1;
+    // flow state of the event-driven mesh NoC (also reset by each state 1 record)
+    meshFlowLatency = 0;
+    meshOutCol.assign(( outType == 2 /* 2D Mesh */)? mesh->numRow : 0, 0);
+    meshInRow = 0;
+
     initialized = true;
 }
 
@@ -134,7 +145,33 @@ void InterConnect::CalculateLatency(const vector<double> infoReadIC) {
     int dataType = (int)infoReadIC[1];
 
     if ( state == 0 ) { return; }  // state 0 - pass
-    else if ( state == 1 ) { readLatency = 0; } // state 1 - reset, else - cumulate
+    else if ( state == 1 ) { // state 1 - reset, else - cumulate
+        readLatency = 0;
+        inputCounter = 0;
+        firstInputLatency = -1;
+        if ( outType == 2 /* 2D Mesh */) {
+            mesh->ClearFlow();
+            meshFlowLatency = 0;
+            meshOutCol.assign(mesh->numRow, 0);
+            meshInRow = 0;
+        }
+    }
+
+    // event-driven mesh NoC: IC records become flows, latency is updated by CalculateFlowLatency
+    if ( (outType == 2 /* 2D Mesh */) && (param->meshModel == 1) ) {
+        if ( dataType == 0 /*output*/) {
+            // output moves to row 0 in its col (subObjects of a row send the output in order of the col)
+            int srcRow = MIN((int)infoReadIC[3], mesh->numRow - 1);
+            int srcCol = meshOutCol[srcRow]++;
+            mesh->AddFlow(srcRow, srcCol, 0, srcCol, infoReadIC[2]/*numRead*/);
+        } else {
+            // input moves from the row of the previous input (numHopsRow is relative to it) and along the row
+            int dstRow = MIN(meshInRow + (int)infoReadIC[3], mesh->numRow - 1);
+            mesh->AddFlow(meshInRow, 0, dstRow, (int)infoReadIC[4], infoReadIC[2]/*numRead*/);
+            meshInRow = dstRow;
+        }
+        return;
+    }
 
     if ( dataType == 0 /*output*/) {
         if ( outType == 0 /* Bus */) { 
@@ -154,6 +191,7 @@ void InterConnect::CalculateLatency(const vector<double> infoReadIC) {
             readLatency += outHBus->readLatency;
         }
     } else { /*input*/
+        prevReadLatency = readLatency;
         if ( inType == 0 /* Bus */) { 
             inBus->CalculateLatency(infoReadIC[2]/*numRead*/);
             readLatency += inBus->readLatency;
@@ -170,8 +208,30 @@ void InterConnect::CalculateLatency(const vector<double> infoReadIC) {
                                     infoReadIC[2]/*numRead*/);
             readLatency += inHBus->readLatency;
         }
+        inputCounter += readLatency - prevReadLatency; // input feeding latency
+        if ( firstInputLatency < 0 ) {
+            firstInputLatency = readLatency - prevReadLatency;
+        }
+    }
+
+}
+
+/* Calculate Latency of the flows in event-driven mesh NoC */
+void InterConnect::CalculateFlowLatency() {
+    if ( (outType == 2 /* 2D Mesh */) && (param->meshModel == 1) && (mesh->flowVector.size() > 0) ) {
+        mesh->CalculateFlowLatency();
+        readLatency += mesh->flowLatency - meshFlowLatency;
+        meshFlowLatency = mesh->flowLatency;
     }
+}
 
+/* Calculate the input feeding latency hidden by the computation of subObjects */
+void InterConnect::CalculateOverlap(double computeLatency) {
+    // double buffering: the input of the next subObjects is fed while the current subObjects compute,
+    // so only the input feeding exceeding the computation is exposed
+    // (nothing computes during the first input transfer, which stays on the critical path)
+    double hiddenInput = MAX(inputCounter - MAX(firstInputLatency, 0), 0);
+    overlapLatency = ( param->inputOverlap == 1 )? MIN(hiddenInput, computeLatency) : 0;
 }
 
 /* Calculate readDynamicEnergy of interconnect */
@@ -1,6 +1,8 @@
 #ifndef MESH_H_
 #define MESH_H_
 
+#include <vector>
+#include <map>
 #include "typedef.h"
 #include "InputParameter.h"
 #include "Technology.h"
@@ -23,6 +25,10 @@ public:
 	void CalculateArea();
 	void CalculateLatency(int numHopsRow, int numHopsCol, double numRead);
 	void CalculatePower(int numHopsRow, int numHopsCol, double numBitAccess, double numRead);
+    // event-driven NoC model: flows of the same scheduling step contend for the links
+    void ClearFlow();
+    void AddFlow(int srcRow, int srcCol, int dstRow, int dstCol, double numFlit);
+    void CalculateFlowLatency();
 
 	/* Properties */
 	bool initialized;	/* Initialization flag */
@@ -43,6 +49,18 @@ public:
    
     DigitalMux mux;
     DFF dff;
+
+    /* Event-driven NoC (XY routing, per-link occupancy, credit-based router flit buffers) */
+    struct Flow {
+        double numFlit;
+        double headLatency;       // latency of the head flit along the path
+        std::vector<int> path;    // link index (router * 6 + port, port 0-3: E/W/S/N, 4: injection, 5: ejection)
+    };
+    std::vector<Flow> flowVector;
+    std::map<int, double> linkOccupancy; // #flits carried by each link (link index -> #flits)
+    int bufferDepth;                   // #flits of router input buffer
+    double flowLatency;                // completion time of the last flow
+    int numFlowSimulated;              // #flows of the last simulation (flows of the step are kept until ClearFlow)
 };
 
 #endif /* MESH_H_ */
@@ -40,6 +40,7 @@
 #include <iostream>
 #include <vector>
 #include "constant.h"
+#include "DesignError.h"
 #include "formula.h"
 #include "CIMArray.h"
 #include "Param.h"
@@ -131,8 +132,8 @@ void CIMArray::Initialize(int _numRow, int _numCol, double _unitWireRes){  //ini
 			cell.widthAccessCMOS = CalculateOnResistance(tech.featureSize, NMOS, inputParameter.temperature, tech) 
                                 * LINEAR_REGION_RATIO / cell.resCellAccess;   //get access CMOS width
 			if (cell.widthAccessCMOS > cell.widthInFeatureSize) {	// Place transistor vertically
-				printf("Transistor width of 1T1R=%.2fF is larger than the assigned cell width=%.2fF in layout\n", cell.widthAccessCMOS, cell.widthInFeatureSize);
-				exit(-1);
+				throw DesignError("accessWidth", "Transistor width of 1T1R=" + to_string(cell.widthAccessCMOS)
+				                  + "F is larger than the assigned cell width=" + to_string(cell.widthInFeatureSize) + "F in layout");
 			}
 
 			cell.resMemCellOn = cell.resCellAccess + cell.resistanceOn;        //calculate single memory cell resistance_ON
@@ -284,8 +285,7 @@ void CIMArray::CalculateArea() {  //calculate layout area for total design
 void CIMArray::CalculateLatency(double columnRes, double weightMatrixRow, double weightMatrixCol, 
                             double numBitInput, bool CalculateclkFreq) {   //calculate latency for different mode 
     if ( weightMatrixCol > (double)numCol ) {
-        cerr << "[Error] weightMatrixCol of the CIMarray cannot exceed the numCol!!" << endl;
-        exit(-1);
+        throw DesignError("arrayCol", "weightMatrixCol of the CIMarray cannot exceed the numCol!!");
     }
 	if (!initialized) {
 		cout << "[Subarray] Error: Require initialization first!" << endl;
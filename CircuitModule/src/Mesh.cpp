@@ -1,8 +1,13 @@
 #include <cmath>
 #include <iostream>
+#include <queue>
+#include <map>
+#include <algorithm>
+#include <functional>
 #include "constant.h"
 #include "typedef.h"
 #include "formula.h"
+#include "DesignError.h"
 #include "Mesh.h"
 #include "Param.h"
 
@@ -21,8 +26,7 @@ void Mesh::Initialize(int _numPort, int _flitSize, int _numRow, int _numCol, dou
 
     numPort = _numPort; // numPort: 5 (1 PE, 4 connection) or numPort: 8 (4 PE, 4 connection)
     if ( !(numPort==5 || numPort==8) ) {
-        cerr << "[Mesh] Mesh only support numPort 5 or 8!" << endl;
-        exit(-1);
+        throw DesignError("meshPort", "[Mesh] Mesh only support numPort 5 or 8!");
     }
     flitSize = _flitSize;
     numRow = _numRow;
@@ -111,6 +115,10 @@ void Mesh::Initialize(int _numPort, int _flitSize, int _numRow, int _numCol, dou
     // mux for crossbar switch
     numMux = numPort * flitSize;
     mux.Initialize(numPort - 1);
+
+    // event-driven NoC
+    bufferDepth = param->meshBufferDepth;
+    ClearFlow();
 	
 	initialized = true;
 }
@@ -229,6 +237,235 @@ void Mesh::CalculatePower(int numHopsRow, int numHopsCol, double numBitAccess, d
     }		
 }
 
+/* Event-driven NoC model
+* Flows (IC records) of a scheduling step inject their flits at the same time, and the flits follow XY routing.
+* A link carries one flit per cycle, which is shared by the flows on the link (max-min fair), and the router input
+* buffer of bufferDepth flits limits the link throughput by the credit round trip. The simulation only moves between
+* flow completion events, so the cost depends on the number of flows rather than the number of flits (cycles).
+* At an event, only the flows sharing links with the completed flow (connected through the links) get a new rate. */
+void Mesh::ClearFlow() {
+    flowVector.clear();
+    linkOccupancy.clear();
+    flowLatency = 0;
+    numFlowSimulated = 0;
+}
+
+void Mesh::AddFlow(int srcRow, int srcCol, int dstRow, int dstCol, double numFlit) {
+	if (!initialized) {
+		cout << "[Mesh] Error: Require initialization first!" << endl;
+        return;
+    }
+
+    // subObject position -> router position (4 subObjects share a router with 8 ports)
+    int div = ( numPort == 8 )? 2 : 1;
+    int row = MIN(srcRow / div, numRouterRow - 1);
+    int col = MIN(srcCol / div, numRouterCol - 1);
+    int endRow = MIN(dstRow / div, numRouterRow - 1);
+    int endCol = MIN(dstCol / div, numRouterCol - 1);
+
+    // latency of a single flit for each hop (same as the analytical model)
+    CalculateLatency(0, 1, 1);
+    double hopLatencyH = readLatency;
+    CalculateLatency(1, 0, 1);
+    double hopLatencyV = readLatency;
+
+    Flow flow;
+    flow.numFlit = numFlit;
+    flow.headLatency = 0;
+    flow.path.push_back((row * numRouterCol + col) * 6 + 4); // injection
+    // X first
+    while ( col != endCol ) {
+        flow.path.push_back((row * numRouterCol + col) * 6 + (( endCol > col )? 0 : 1));
+        col += ( endCol > col )? 1 : -1;
+        flow.headLatency += hopLatencyH;
+    }
+    // then Y
+    while ( row != endRow ) {
+        flow.path.push_back((row * numRouterCol + col) * 6 + (( endRow > row )? 2 : 3));
+        row += ( endRow > row )? 1 : -1;
+        flow.headLatency += hopLatencyV;
+    }
+    flow.path.push_back((row * numRouterCol + col) * 6 + 5); // ejection
+    flowVector.push_back(flow);
+}
+
+void Mesh::CalculateFlowLatency() {
+
+    // the flows of the step are simulated again only when new flows are added (all flows inject at time 0)
+    if ( (int)flowVector.size() == numFlowSimulated ) { return; }
+    numFlowSimulated = flowVector.size();
+
+    // time of a flit on a link (cycle for synchronous, sec for asynchronous)
+    double flitTime = param->synchronous? 1 : 1 / clkFreq;
+    // credit round trip limits the throughput of a router link with a shallow input buffer
+    CalculateLatency(0, 1, 1);
+    double creditRoundTrip = 2 * readLatency / flitTime + 1;
+    double routerLinkCapacity = MIN(1.0, bufferDepth / creditRoundTrip) / flitTime;
+
+    // links used by the flows (compact index) & the flows on each link
+    int numFlow = flowVector.size();
+    map<int, int> linkIndex;
+    vector<int> linkVector;
+    vector<vector<int>> pathVector(numFlow), linkFlow;
+    for ( int flowIdx=0; flowIdx < numFlow; flowIdx++ ) {
+        for ( auto link : flowVector[flowIdx].path ) {
+            if ( linkIndex.find(link) == linkIndex.end() ) {
+                linkIndex[link] = linkVector.size();
+                linkVector.push_back(link);
+                linkFlow.push_back(vector<int>());
+            }
+            pathVector[flowIdx].push_back(linkIndex[link]);
+            linkFlow[linkIndex[link]].push_back(flowIdx);
+        }
+    }
+    int numLink = linkVector.size();
+    vector<double> linkCapacity(numLink), occupancy(numLink, 0);
+    for ( int linkIdx=0; linkIdx < numLink; linkIdx++ ) {
+        linkCapacity[linkIdx] = ( linkVector[linkIdx] % 6 < 4 )? routerLinkCapacity : 1 / flitTime;
+    }
+
+    // remained flits of a flow are brought up to date only when its rate changes (lastTime: time of the update)
+    vector<double> remained(numFlow), rate(numFlow, 0), lastTime(numFlow, 0);
+    vector<int> version(numFlow, 0);
+    vector<bool> active(numFlow);
+    int numActive = 0;
+    for ( int flowIdx=0; flowIdx < numFlow; flowIdx++ ) {
+        remained[flowIdx] = flowVector[flowIdx].numFlit;
+        active[flowIdx] = ( remained[flowIdx] > 0 );
+        numActive += active[flowIdx]? 1 : 0;
+    }
+
+    // event queue of flow completion (time, (flow, version of the flow rate))
+    typedef pair<double, pair<int, int>> Event;
+    priority_queue<Event, vector<Event>, greater<Event>> eventQueue;
+    double time = 0;
+    flowLatency = 0;
+
+    // move a flow to the current time with its rate
+    auto advance = [&](int flowIdx) {
+        double duration = time - lastTime[flowIdx];
+        remained[flowIdx] -= rate[flowIdx] * duration;
+        for ( auto linkIdx : pathVector[flowIdx] ) { occupancy[linkIdx] += rate[flowIdx] * duration; }
+        lastTime[flowIdx] = time;
+    };
+
+    // max-min fair rate of a group of active flows (progressive filling) & their completion with the new rate
+    // (the group holds every active flow on its links, so the flows out of the group keep their rate)
+    vector<double> residual(numLink);
+    vector<int> numUnfixed(numLink, 0);
+    vector<bool> fixed(numFlow, false);
+    auto fillRate = [&](const vector<int> &flowGroup, const vector<int> &linkGroup) {
+        for ( auto linkIdx : linkGroup ) {
+            residual[linkIdx] = linkCapacity[linkIdx];
+            numUnfixed[linkIdx] = 0;
+        }
+        for ( auto flowIdx : flowGroup ) {
+            fixed[flowIdx] = false;
+            for ( auto linkIdx : pathVector[flowIdx] ) { numUnfixed[linkIdx]++; }
+        }
+        int numFixed = 0;
+        while ( numFixed < flowGroup.size() ) {
+            // bottleneck link
+            int bottleneck = -1;
+            double share = 0;
+            for ( auto linkIdx : linkGroup ) {
+                if ( (numUnfixed[linkIdx] > 0) && ((bottleneck < 0) || (residual[linkIdx] / numUnfixed[linkIdx] < share)) ) {
+                    bottleneck = linkIdx;
+                    share = residual[linkIdx] / numUnfixed[linkIdx];
+                }
+            }
+            // fix the rate of the flows on the bottleneck link
+            for ( auto flowIdx : linkFlow[bottleneck] ) {
+                if ( !active[flowIdx] || fixed[flowIdx] ) { continue; }
+                rate[flowIdx] = share;
+                fixed[flowIdx] = true;
+                numFixed++;
+                for ( auto linkIdx : pathVector[flowIdx] ) {
+                    residual[linkIdx] -= share;
+                    numUnfixed[linkIdx]--;
+                }
+            }
+        }
+        for ( auto flowIdx : flowGroup ) {
+            version[flowIdx]++;
+            eventQueue.push(Event(time + remained[flowIdx] / rate[flowIdx], make_pair(flowIdx, version[flowIdx])));
+        }
+    };
+
+    vector<int> flowGroup, linkGroup;
+    for ( int flowIdx=0; flowIdx < numFlow; flowIdx++ ) {
+        if ( active[flowIdx] ) { flowGroup.push_back(flowIdx); }
+    }
+    for ( int linkIdx=0; linkIdx < numLink; linkIdx++ ) {
+        linkGroup.push_back(linkIdx);
+    }
+    fillRate(flowGroup, linkGroup);
+
+    vector<bool> flowVisited(numFlow, false), linkVisited(numLink, false);
+    while ( numActive > 0 ) {
+        // next valid event (events scheduled with the old rate are discarded)
+        while ( eventQueue.top().second.second != version[eventQueue.top().second.first] ) {
+            eventQueue.pop();
+        }
+        Event event = eventQueue.top();
+        eventQueue.pop();
+        time = event.first;
+
+        // last flit is injected -> arrives at the destination after the head latency
+        int doneIdx = event.second.first;
+        advance(doneIdx);
+        active[doneIdx] = false;
+        numActive--;
+        flowLatency = MAX(flowLatency, time + flowVector[doneIdx].headLatency);
+
+        // only the flows connected to the completed flow through shared links change their rate
+        flowGroup.clear();
+        linkGroup.clear();
+        for ( auto linkIdx : pathVector[doneIdx] ) {
+            linkVisited[linkIdx] = true;
+            linkGroup.push_back(linkIdx);
+        }
+        for ( int groupIdx=0; groupIdx < linkGroup.size(); groupIdx++ ) {
+            for ( auto flowIdx : linkFlow[linkGroup[groupIdx]] ) {
+                if ( !active[flowIdx] || flowVisited[flowIdx] ) { continue; }
+                flowVisited[flowIdx] = true;
+                flowGroup.push_back(flowIdx);
+                for ( auto linkIdx : pathVector[flowIdx] ) {
+                    if ( !linkVisited[linkIdx] ) {
+                        linkVisited[linkIdx] = true;
+                        linkGroup.push_back(linkIdx);
+                    }
+                }
+            }
+        }
+        for ( auto linkIdx : linkGroup ) { linkVisited[linkIdx] = false; }
+
+        // flows of the group completed at the same time
+        int numGroupActive = 0;
+        for ( auto flowIdx : flowGroup ) {
+            flowVisited[flowIdx] = false;
+            advance(flowIdx);
+            if ( remained[flowIdx] <= 1e-9 * flowVector[flowIdx].numFlit ) {
+                active[flowIdx] = false;
+                version[flowIdx]++; // its completion event is discarded
+                numActive--;
+                flowLatency = MAX(flowLatency, time + flowVector[flowIdx].headLatency);
+            } else {
+                flowGroup[numGroupActive++] = flowIdx;
+            }
+        }
+        flowGroup.resize(numGroupActive);
+        fillRate(flowGroup, linkGroup);
+    }
+
+    for ( int linkIdx=0; linkIdx < numLink; linkIdx++ ) {
+        linkOccupancy[linkVector[linkIdx]] = occupancy[linkIdx];
+    }
+    if ( param->synchronous ) {
+        flowLatency = ceil(flowLatency);
+    }
+}
+
 void Mesh::PrintProperty(const char* str) {
 	FunctionUnit::PrintProperty(str);
 }
@@ -0,0 +1,46 @@
+/*********************************************************************************************
+* Definition of the Architecture Generator (designArch from the design params of a network)
+*********************************************************************************************/
+
+#ifndef ARCHGENERATOR_H_
+#define ARCHGENERATOR_H_
+
+#include <vector>
+#include "InputParameter.h"
+#include "Technology.h"
+#include "MemCell.h"
+#include "HierarchyRoot.h"
+#include "InfoReadTable.h"
+
+using namespace std;
+
+class ArchGenerator {
+//private:
+public:
+    ArchGenerator(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell);
+    virtual ~ArchGenerator() {}
+    InputParameter& inputParameter;
+    Technology& tech;
+    MemCell& cell;
+
+    /* Functions */
+    void Initialize(HierarchyRoot *_hRoot, const vector<vector<vector<int>>> &_networkStructureVector,
+                    int _scheduler_type);
+    // designArch for the design params (numSubObject, IC, BU of each hierarchy), top-level sized by the mapper
+    vector<vector<int>> Generate(const vector<vector<int>> &archParams);
+    // max fanIn, fanOut, fmap, maxPool window of the layers
+    vector<int> GetNetworkMax(const vector<vector<int>> &networkStructure);
+
+    /* Properties */
+    HierarchyRoot *hRoot;
+    int scheduler_type;
+    int maxNumDU;
+    vector<vector<vector<double>>> networkStructureVector; // networks of the portfolio
+    vector<int> networkMax;                               // max over the layers of the portfolio
+
+    /* Result */
+    vector<InfoReadTable> networkInfoReadVector;          // mapping of each network on the generated design
+
+}; /* class ArchGenerator */
+
+#endif /* ARCHGENERATOR_H_ */
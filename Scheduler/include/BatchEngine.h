@@ -0,0 +1,144 @@
+/*********************************************************************************************
+* Definition of the Batch Engine (in-process DSE over the design space)
+*********************************************************************************************/
+
+#ifndef BATCHENGINE_H_
+#define BATCHENGINE_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <stdio.h>
+#include <sys/types.h>
+#include "InputParameter.h"
+#include "Technology.h"
+#include "MemCell.h"
+#include "HierarchyRoot.h"
+#include "HierarchyObject.h"
+#include "ArchGenerator.h"
+#include "DesignSpace.h"
+#include "ParetoFront.h"
+
+using namespace std;
+
+/* status of a design point */
+enum DesignStatus {
+    DESIGN_EVALUATED = 0,   // simulated & meets the constraints
+    DESIGN_INFEASIBLE = 1,  // simulated, but violates a constraint
+    DESIGN_PRUNED = 2,      // skipped before scheduling (bound violates a constraint or is dominated)
+    DESIGN_FAILED = 3,      // worker process died during the design
+    DESIGN_DUPLICATE = 4    // same architecture as a completed design (reason: its designIdx), results are shared
+};
+
+/* summary metrics of a design point */
+struct DesignResult {
+    int designIdx;
+    int arrayIdx;       // CIM array of the design
+    int numHierarchy;
+    double area;        // m^2
+    double energy;      // J (with leakage, weighted over the networks)
+    double latency;     // s
+    double power;       // W (average)
+    double topsw, tops;
+    int status;         // DesignStatus
+    string reason;      // constraint or dominance that pruned the design (exit status of a failed design)
+    string designKey;   // canonical design (empty if the architecture was not generated)
+
+    /* lower bounds before scheduling (CIM array work of the mapping) */
+    double energyBound, latencyBound, powerBound;
+    double topsBound;   // upper bound
+
+    /* metrics of each network (energy_with_leakage [pJ], latency [ps], topsw, tops) */
+    vector<vector<double>> networkMetric;
+};
+
+class BatchEngine {
+//private:
+public:
+    BatchEngine(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell);
+    virtual ~BatchEngine() {}
+    InputParameter& inputParameter;
+    Technology& tech;
+    MemCell& cell;
+
+    /* Functions */
+    void Initialize(const DesignSpace *_designSpace, const vector<vector<vector<int>>> &_networkStructureVector,
+                    const vector<string> &_networkNames, const vector<double> &_networkWeights,
+                    int _scheduler_type, const string &_basefolder);
+    // CIM array of the design (one HierarchyRoot per distinct array params, shared by the hierarchy designs)
+    HierarchyRoot* GetRoot(int arrayIdx);
+    // generate, simulate & save a design point (infeasible if the design throws a DesignError)
+    DesignResult EvaluateDesign(int designIdx);
+    DesignResult SimulateDesign(int designIdx);
+    // bounds of the design from its area/leakage & the CIM array work of the mapping (before scheduling)
+    void CalculateBound(HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector,
+                        double clkPeriod, DesignResult *result);
+    // canonical key of a design: CIM array & derived properties of the HierarchyObjects
+    string GetDesignKey(int arrayIdx, const vector<HierarchyObject*> &hObjectVector) const;
+    // constraint violated by the design ("" if none), bound: check the bounds instead of the results
+    string CheckConstraint(const DesignResult &result, bool bound) const;
+    // statistics, Pareto front & summary of a completed design, true if the design is on the front
+    bool RecordResult(const DesignResult &result);
+    // append a completed design to the journal (checkpoint every checkpointInterval designs)
+    void CommitResult(const DesignResult &result);
+    // Pareto front of the feasible designs (area, energy, latency), true if the design is on the front
+    bool UpdatePareto(const DesignResult &result);
+    // delete the breakdown files of a design (dominated after it was saved)
+    void RemoveBreakdown(int designIdx);
+    // one-line summary of every design (designs.csv) & the final front (pareto.csv)
+    void SaveDesignSummary(const DesignResult &result);
+    void SavePareto();
+    // journal of the completed designs (replayed on restart, a partial last record is dropped)
+    void OpenJournal();
+    bool ParseJournal(const string &line, DesignResult *result) const;
+    void SaveJournal(const DesignResult &result);
+    // journal synced to disk & pareto.csv/checkpoint.csv replaced atomically
+    void Checkpoint();
+    // local worker processes pulling designs from a shared work queue, each with its own journal shard
+    void RunWorkers(const vector<int> &pendingVector);
+    pid_t SpawnWorker(int workerIdx, int *queue, const vector<int> &pendingVector);
+    // design of a dead worker reported as failed (not retried on resume)
+    void FailDesign(int designIdx, const string &reason);
+    // merge the complete records of the shards into the journal (final: remove the shards)
+    void MergeShards(bool final);
+    // journal replayed (Start), batches of designs evaluated in order or by the workers (EvaluateBatch), final front (Finish)
+    void Start();
+    void EvaluateBatch(const vector<int> &designIdxVector);
+    void Finish();
+    // exhaustive sweep of the design space
+    void Run();
+
+    /* Properties */
+    const DesignSpace *designSpace;
+    vector<vector<vector<int>>> networkStructureVector;
+    vector<vector<vector<double>>> networkStructureVector_db;
+    vector<string> networkNames;
+    vector<double> networkWeights;
+    int scheduler_type;
+    string basefolder;
+    double clkFreq;     // clock frequency before the design (lowered by the clock period of each CIM array)
+    vector<double> networkComputation; // operations of each network
+
+    /* Pareto front & statistics */
+    ParetoFront paretoFront;
+    map<int, DesignResult> paretoResult;    // results of the designs on the front
+    int numEvaluated, numInfeasible, numPruned, numFailed, numDuplicate;
+    map<string, DesignResult> designKeyMap; // first completed design of each canonical key
+    map<int, DesignResult> resultMap;       // results of every completed design (search driver)
+
+    /* Journal */
+    FILE *journal;
+    vector<char> completed;     // designs in the journal
+    int numCompleted;
+    int numSinceCheckpoint;
+    bool resumed;               // journal of an interrupted run replayed
+    bool worker;                // worker process (designs.csv & breakdowns of dominated designs are left to the coordinator)
+    map<string, long> shardOffset; // merged length of each shard
+
+    ArchGenerator archGenerator;
+    map<int, unique_ptr<HierarchyRoot>> rootCache;
+
+}; /* class BatchEngine */
+
+#endif /* BATCHENGINE_H_ */
@@ -0,0 +1,70 @@
+/*********************************************************************************************
+* Definition of the Design Space (CIM array & hierarchy design points of the batch DSE)
+*********************************************************************************************/
+
+#ifndef DESIGNSPACE_H_
+#define DESIGNSPACE_H_
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+class DesignSpace {
+//private:
+public:
+    DesignSpace();
+    virtual ~DesignSpace() {}
+
+    /* Functions */
+    // sweep config (csv rows of name,value,value,...)
+    void ReadConfig(const string &filename);
+    void Enumerate();
+    // designs of the sweep (search: upper bound of the designs proposed by the search driver)
+    int Size() const;
+    int GetArrayIdx(int designIdx) const;
+    // design params (numSubObjectRow, numSubObjectCol, IC & BU params of each hierarchy) of arch_generator_for_net
+    vector<vector<int>> GetDesignParam(int designIdx) const;
+    // set the CIM array params (numRowCIMArray, numColCIMArray, levelOutput, numColMuxed) of the design
+    void ApplyArrayParam(int arrayIdx) const;
+    // design point proposed by the search driver (designIdx of the design)
+    int AddDesign(int arrayIdx, const vector<vector<int>> &designParam);
+    // sweep dimensions, constraints & search settings (the journal of a run is only resumed with the same ones)
+    string Describe() const;
+
+    /* Sweep dimensions */
+    int maxNumHierarchy;
+    vector<int> numSubObjectRowList, numSubObjectColList;       // numSubObject of the non-top hierarchies
+    vector<int> designParamICBU, designParamICBUTop;            // IC & BU params of the non-top/top hierarchies
+    vector<int> numRowCIMArrayList, numColCIMArrayList, levelOutputList, numColMuxedList;
+
+    /* Constraints (0: no constraint) & pruning */
+    double maxArea;         // mm^2
+    double minTOPS;         // TOPS
+    double maxPower;        // W (average power)
+    int pruneDominated;     // 1: skip designs whose lower bounds are dominated by a design found already
+
+    /* Outputs */
+    int saveAll;            // 1: breakdowns & metric files of every design (0: designs on the Pareto front only)
+    int checkpointInterval; // designs between checkpoints (0: at the end only)
+    int numWorker;          // local worker processes (0: designs are evaluated in the main_dse process)
+
+    /* Search (NSGA-II over the hierarchy design params instead of the exhaustive sweep) */
+    int searchPopulation;   // designs per generation (0: exhaustive sweep)
+    int searchGeneration;   // generations after the initial population
+    int searchSeed;         // seed of the random proposals
+    int searchSurrogate;    // 1: offspring screened by a Gaussian-process surrogate of the evaluated designs
+    // IC & BU knobs of each hierarchy (empty: fixed by designParamICBU/designParamICBUTop)
+    vector<int> outTypeList, inTypeList;    // IC types (inType: ports of a 2D mesh outType)
+    vector<int> busWidthList;               // outBW & inBW of the IC
+    vector<int> buTypeList, coreBWList;     // BU type & outCoreBW
+
+    /* Design points (sweep: designIdx = arrayIdx * #hierarchyDesign + hierarchyIdx, search: order of the proposals) */
+    vector<vector<int>> arrayParamVector;                       // numRowCIMArray, numColCIMArray, levelOutput, numColMuxed
+    vector<vector<vector<int>>> hierarchyDesignVector;          // numSubObject (row, col) of each hierarchy
+    vector<int> proposalArrayIdx;                               // CIM array of each proposed design
+    vector<vector<vector<int>>> proposalDesignParam;            // design params of each proposed design
+
+}; /* class DesignSpace */
+
+#endif /* DESIGNSPACE_H_ */
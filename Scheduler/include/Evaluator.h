@@ -0,0 +1,80 @@
+/*********************************************************************************************
+* Definition of the Evaluator (scheduling & performance of networks on an initialized architecture)
+*********************************************************************************************/
+
+#ifndef EVALUATOR_H_
+#define EVALUATOR_H_
+
+#include <vector>
+#include <string>
+#include "HierarchyRoot.h"
+#include "HierarchyObject.h"
+#include "NetworkScheduler.h"
+
+using namespace std;
+
+/* Evaluation result of a network */
+class NetworkEvaluation {
+//private:
+public:
+    NetworkEvaluation() {}
+    virtual ~NetworkEvaluation() {}
+
+    /* Network */
+    string name;
+    double weight;              // weight of the network in the aggregate (normalized)
+    vector<vector<double>> networkStructure;
+    double numComputation;
+
+    /* Scheduling Result */
+    NetworkScheduler networkScheduler;
+
+    /* Performance Result (cycle / J / W) */
+    vector<vector<double>> networkLatencyVector, networkEnergyVector;
+    vector<vector<double>> layerLatencyVector2, layerEnergyVector2, networkLatencyVector2, networkEnergyVector2;
+    vector<double> chipLatencyVector, chipEnergyVector;
+    double chipLeakage;
+    double imageLatency;        // latency per image (pipeline interval / average over the batch)
+    double latency;             // latency of a single image
+    double chipLeakageEnergy;
+    double topsw, tops;
+
+};
+
+class Evaluator {
+//private:
+public:
+    Evaluator() {}
+    virtual ~Evaluator() {}
+
+    /* Functions */
+    void Initialize(HierarchyRoot *_hRoot, const vector<HierarchyObject*> &_hObjectVector, double _clkPeriod);
+    void AddNetwork(const string &name, const vector<vector<double>> &networkStructure, double weight);
+
+    // map every network on the architecture (networks are scheduled in parallel)
+    void Scheduling(int scheduler_type);
+    // mapping of the same networks on another design with the same structure (instead of Scheduling,
+    // valid only if the scheduler reads no field that differs, e.g. clkFreq or delaytolerance)
+    void ReuseSchedule(const Evaluator &base);
+    // latency/energy of every network & weighted aggregate (the hierarchy is shared, so networks are evaluated in turn)
+    void CalculatePerformance();
+
+    /* Architecture */
+    HierarchyRoot *hRoot;
+    vector<HierarchyObject*> hObjectVector;
+    double clkPeriod;
+
+    /* Networks */
+    vector<NetworkEvaluation> networkVector;
+
+    /* Weighted aggregate over the networks */
+    double numComputation;
+    double dynamicEnergy, leakageEnergy;
+    double imageLatency, latency;
+    double topsw, tops;
+    vector<double> chipLatencyVector, chipEnergyVector;
+    vector<vector<double>> networkLatencyVector2, networkEnergyVector2;
+
+}; /* class Evaluator */
+
+#endif /* EVALUATOR_H_ */
@@ -0,0 +1,37 @@
+/*********************************************************************************************
+* Definition of the Gaussian Process (surrogate of the design metrics for the search driver)
+*********************************************************************************************/
+
+#ifndef GAUSSIANPROCESS_H_
+#define GAUSSIANPROCESS_H_
+
+#include <vector>
+
+using namespace std;
+
+class GaussianProcess {
+//private:
+public:
+    GaussianProcess(double _lengthScale, double _noise);
+    virtual ~GaussianProcess() {}
+
+    /* Functions */
+    // fit the outputs (targetVector[i]: outputs of inputVector[i]), each output standardized
+    void Fit(const vector<vector<double>> &_inputVector, const vector<vector<double>> &targetVector);
+    // posterior mean & standard deviation of each output at the input
+    void Predict(const vector<double> &input, vector<double> *mean, vector<double> *std) const;
+    // squared exponential kernel
+    double Kernel(const vector<double> &a, const vector<double> &b) const;
+    int Size() const { return inputVector.size(); }
+
+    /* Properties */
+    double lengthScale;     // of the inputs (normalized to [0, 1])
+    double noise;           // variance of the standardized outputs
+    vector<vector<double>> inputVector;
+    vector<vector<double>> choleskyL;           // lower triangular factor of the kernel matrix
+    vector<vector<double>> alphaVector;         // K^-1 y of each output
+    vector<double> targetMean, targetStd;
+
+}; /* class GaussianProcess */
+
+#endif /* GAUSSIANPROCESS_H_ */
@@ -0,0 +1,99 @@
+/*********************************************************************************************
+* Definition of the InfoRead Table (compact storage of the scheduling results)
+*********************************************************************************************/
+
+#ifndef INFOREADTABLE_H_
+#define INFOREADTABLE_H_
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <limits>
+#include <cmath>
+#include <stdlib.h>
+#include <stdint.h>
+#include "DesignError.h"
+
+using namespace std;
+
+/* type of a scheduling record */
+enum InfoReadType {
+    INFOREAD_ROOT = 0,   // HierarchyRoot (CIM array) operation
+    INFOREAD_OBJECT = 1, // HierarchyObject operation (DE, BU)
+    INFOREAD_IC = 2      // interconnect transfer of a HierarchyObject
+};
+
+/* common part of every record */
+struct InfoRead {
+    uint16_t layerIdx;
+    uint8_t hlevel;
+    uint8_t type;       // InfoReadType
+    uint16_t idxRow, idxCol;
+    uint32_t idxData;   // index of the record in the payload vector of its type
+};
+
+/* payload of HierarchyRoot record */
+struct InfoReadRoot {
+    uint16_t weightMatrixRow, weightMatrixCol;
+    uint8_t numBitInput, numCellPerSynapse;
+    double numRead;     // numReadArray
+};
+
+/* payload of IC record */
+struct InfoReadIC {
+    double numRead;
+    int16_t numHopsRow; // hops (mesh/HBus) or numSubObjectRow (LinearArray)
+    int16_t numHopsCol; // hops (mesh/HBus) or numSubObjectCol (LinearArray)
+    uint8_t state;      // 0: none, 1: reset, 2: cumulate
+    uint8_t dataType;   // 0: output, 1: input
+};
+
+/* payload of HierarchyObject record */
+struct InfoReadObject {
+    uint32_t weightMatrixRow, weightMatrixCol; // wRow * wCol * wInC, wOutC
+    uint32_t numUnitAdd;
+    double numReadAdderTree, numReadReLu, numReadMaxPool;
+    double infoReadBU[6]; // numOutRead, numOutWrite, outParallelism, numInRead, numInWrite, inParallelism
+};
+
+/* Convert a scheduling value to the narrow (integer) type of its record field */
+template <typename T>
+T InfoReadField(double value, const char *name) {
+    if ( (value < (double)numeric_limits<T>::min()) || (value > (double)numeric_limits<T>::max())
+         || (value != floor(value)) ) {
+        throw DesignError("infoReadField", string(name) + " (" + to_string(value) + ") does not fit in the scheduling record");
+    }
+    return (T)value;
+}
+
+class InfoReadTable {
+//private:
+public:
+    InfoReadTable() {}
+    virtual ~InfoReadTable() {}
+
+    /* Functions */
+    void Clear();
+    int Size() const { return header.size(); }
+    void PushRoot(int layerIdx, double idxRow, double idxCol, const InfoReadRoot &root);
+    void PushObject(int layerIdx, int hlevel, double idxRow, double idxCol, const InfoReadObject &object);
+    void PushIC(int layerIdx, int hlevel, double idxRow, double idxCol, const InfoReadIC &ic);
+
+    // infoRead slices consumed by HierarchyRoot/HierarchyObject (same layout as the component APIs)
+    vector<double> GetInfoReadHRoot(int infoIdx) const;
+    vector<double> GetInfoReadHObject(int infoIdx) const;
+    vector<double> GetInfoReadIC(int infoIdx) const;
+    // full record in the csv layout (lengthInfoRead for root/object, lengthInfoReadForIC for IC)
+    vector<double> GetInfoRead(int infoIdx) const;
+
+    void SaveCSV(const string &filename) const;
+
+    /* Records */
+    vector<InfoRead> header;
+    vector<InfoReadRoot> root;
+    vector<InfoReadObject> object;
+    vector<InfoReadIC> ic;
+
+}; /* class InfoReadTable */
+
+#endif /* INFOREADTABLE_H_ */
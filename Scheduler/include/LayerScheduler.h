@@ -8,6 +8,7 @@
 #include <vector>
 #include "HierarchyRoot.h"
 #include "HierarchyObject.h"
+#include "InfoReadTable.h"
 
 using namespace std;
 
@@ -20,23 +21,23 @@ public:
     /* Functions */
     void Initialize(int _layerIdx, const vector<double> _layerStructure,
                     int _hlevelMappingUnit, vector<vector<int>> _idxOffsetVector,
-                    const HierarchyObject* hTop);
+                    const HierarchyObject* hTop, int _numReplica);
     void CheckLinearArray(const HierarchyObject* hObject);
 
-    vector<double> HRootScheduling(const HierarchyRoot* hRoot, double idxRow, double idxCol,
-                                double weightMatrixRow, double weightMatrixCol);
+    // scheduling results are appended to infoReadTable
+    void HRootScheduling(const HierarchyRoot* hRoot, double idxRow, double idxCol,
+                                double weightMatrixRow, double weightMatrixCol, InfoReadTable *infoReadTable);
     // scheduler type00 - base (tile-wise mapping)
-    vector<vector<double>> HObjectScheduling_00(const HierarchyObject* hObject, double idxRow, double idxCol,
+    void HObjectScheduling_00(const HierarchyObject* hObject, double idxRow, double idxCol,
                                 double wRow, double wCol, double wInC, double wOutC,
-                                bool offsetObject, bool lastObject);
+                                bool offsetObject, bool lastObject, InfoReadTable *infoReadTable);
     // scheduler type01 - compact
-    vector<vector<double>> HObjectScheduling_01(const HierarchyObject* hObject, double idxRow, double idxCol,
+    void HObjectScheduling_01(const HierarchyObject* hObject, double idxRow, double idxCol,
                                 double numRowObjectAvailable, double numColObjectAvailable,
-                                double wRow, double wCol, double wInC, double wOutC);
+                                double wRow, double wCol, double wInC, double wOutC, InfoReadTable *infoReadTable);
 
     /* Scheduling Parameter (Architecture/Network info) */
     int numBitInput, numColMuxed, numCellPerSynapse;
-    int lengthInfoRead;
     int hlevelRowSystolic, hlevelColSystolic;
     int numHObjectRowSAExt, numHObjectColSAExt; // number of hObject lie in the row/col dim for Systolic Array Extension
                                                 // NOTE: assume that the extension can be finished in the parent hObject
@@ -45,6 +46,8 @@ public:
     int layerIdx;
     vector<double> layerStructure;
     double inW, inH, inC, kW, kH, outC, fanIn, fanOut, outW, outH, numConv;
+    int numReplica; // number of weight replicas on the top-level subObjects (compact mapping)
+    bool replicable; // weight replication requires linear address of the top-level subObjects
     int hlevelMappingUnit; // hLevel used for mapping unit
     int hlevelTop;
     vector<vector<int>> idxOffsetVector; // hlevel, idxOffsetRow, idxOffsetCol
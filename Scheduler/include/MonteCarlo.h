@@ -0,0 +1,60 @@
+/*********************************************************************************************
+* Definition of the Monte Carlo device variation engine
+*********************************************************************************************/
+
+#ifndef MONTECARLO_H_
+#define MONTECARLO_H_
+
+#include <vector>
+#include <map>
+#include <tuple>
+#include <string>
+#include "HierarchyRoot.h"
+#include "HierarchyObject.h"
+#include "InfoReadTable.h"
+
+using namespace std;
+
+class MonteCarlo {
+//private:
+public:
+    MonteCarlo() {}
+    virtual ~MonteCarlo() {}
+
+    /* Functions */
+    // collect the array operations of the schedule & tabulate the array for the variation range
+    void Initialize(HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector, const InfoReadTable &networkInfoRead);
+    // sample device variation of each array operation (OpenMP over samples)
+    void Run(int numSample);
+    void PrintResult();
+    void SaveCSV(const string &filename);
+
+    /* Array operations of the schedule (grouped by the array configuration) */
+    typedef tuple<double, double, double> ArrayKey; // weightMatrixRow, weightMatrixCol, numBitInput
+    struct ArrayRead {
+        int keyIdx;
+        int arrayIdx;       // physical array (arrays touched by the schedule, in order of the first read)
+        double numRead;
+    };
+    vector<ArrayKey> keyVector;
+    vector<ArrayRead> arrayReadVector;
+    int numArray;
+
+    /* Tables over the variation of the column resistance (log-scale factor) */
+    int numGrid;
+    double gridStep;                     // step of log(columnRes / nominal columnRes)
+    vector<vector<double>> energyTable;  // ADC energy per read [keyIdx][grid]
+    vector<vector<double>> latencyTable; // sensing latency [keyIdx][grid]
+
+    /* Column resistance of the nominal & variated device */
+    HierarchyRoot *hRoot;
+    double columnRes;
+
+    /* Result */
+    double nominalEnergy, nominalLatency;
+    vector<double> energyVector;  // ADC energy of each sample (per image)
+    vector<double> latencyVector; // sensing latency of the slowest array of each sample (mean over the read noise, clock period)
+
+}; /* class MonteCarlo */
+
+#endif /* MONTECARLO_H_ */
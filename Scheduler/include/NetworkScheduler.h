@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "HierarchyObject.h"
+#include "InfoReadTable.h"
 
 using namespace std;
 
@@ -20,7 +21,13 @@ public:
     void Initialize(const vector<vector<double>> _networkStructure,
                     const HierarchyObject *_hTop);
 
-    vector<vector<double>> Scheduling(int scheduler_type); // calculate #top level objects
+    const InfoReadTable& Scheduling(int scheduler_type); // calculate #top level objects
+    void MapNetwork(int scheduler_type); // map all layers with numReplicaVector
+
+    // weight replication of the bottleneck layers under param->replicaBudget (update numReplicaVector)
+    void BalanceReplica(int scheduler_type, HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector);
+    double MappingLatency(HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector,
+                          vector<double> *layerSubLatency);
 
     void CalculatePerformance(vector<vector<double>> *networkLatencyVector,
                               vector<vector<double>> *networkEnergyVector,
@@ -28,8 +35,19 @@ public:
                               vector<vector<double>> *layerEnergyVector2,
                               vector<vector<double>> *networkLatencyVector2,
                               vector<vector<double>> *networkEnergyVector2,
-                              HierarchyRoot *hRoot, vector<HierarchyObject*> hObjectVector,
-                              const vector<vector<double>> networkInfoRead);
+                              HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector,
+                              const InfoReadTable &networkInfoRead);
+
+    // pipelined execution (each layer is a pipeline stage, requires CalculatePerformance first)
+    void CalculatePipeline(const vector<vector<double>> *layerLatencyVector2);
+
+    // batched execution of batchSize images (imageLatency: latency of a single image, requires CalculatePipeline first)
+    void CalculateBatch(int batchSize, double imageLatency);
+
+    // leakage power with the units idle in each layer power gated (requires CalculatePerformance first)
+    double CalculatePowerGating(double chipLeakage, HierarchyRoot *hRoot,
+                                const vector<HierarchyObject*> &hObjectVector, const InfoReadTable &networkInfoRead,
+                                const vector<vector<double>> *networkLatencyVector);
 
     /* Network Properties */
     vector<vector<double>> networkStructure;
@@ -37,9 +55,30 @@ public:
     const HierarchyObject* hTop;
     int hlevelMappingUnit;
     int numUsedSubObject_top;
+    vector<int> numReplicaVector; // number of weight replicas of each layer
 
     /* Scheduling Result*/
-    vector<vector<double>> networkInfoRead;
+    InfoReadTable networkInfoRead;
+
+    /* Performance Result (cycle) */
+    vector<double> topSubObjectLatency; // busy time of each top-level subObject (sum over layers)
+
+    /* Pipeline Result (cycle) */
+    vector<vector<double>> pipelineStageVector; // layerIdx, subObject latency, top-level latency
+    double pipelineInterval;        // initiation interval (steady-state latency per image)
+    double pipelineLatency;         // latency of a single image through the pipeline (fill/drain)
+    double pipelineSharedLatency;   // top-level DE/BU/IC latency of all stages
+    int pipelineBottleneck;         // busiest top-level subObject (-1: shared top-level DE/BU/IC)
+
+    /* Batch Result (cycle) */
+    double batchLatency;            // latency of the entire batch
+    double batchInterval;           // interval between consecutive images of the batch (average in layer-by-layer process)
+    int numImageInFlight;           // number of images processed concurrently (group of layer-by-layer process)
+    double fmapBit;                 // activation footprint of an image waiting between stages
+
+    /* Power Gating Result */
+    long long numGatingUnit;        // number of units at powerGatingLevel
+    double numActiveUnit;           // number of active units (time-weighted average over the layers)
 
 };
 
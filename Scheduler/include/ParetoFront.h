@@ -0,0 +1,37 @@
+/*********************************************************************************************
+* Definition of the Pareto Front (non-dominated designs in area, energy & latency)
+*********************************************************************************************/
+
+#ifndef PARETOFRONT_H_
+#define PARETOFRONT_H_
+
+#include <vector>
+
+using namespace std;
+
+/* objectives of a design point (all minimized) */
+struct ParetoPoint {
+    int id;             // designIdx
+    double area, energy, latency;
+};
+
+class ParetoFront {
+//private:
+public:
+    ParetoFront() {}
+    virtual ~ParetoFront() {}
+
+    /* Functions */
+    void Clear() { pointVector.clear(); }
+    int Size() const { return pointVector.size(); }
+    // true if a point of the front dominates the point
+    bool IsDominated(const ParetoPoint &point) const;
+    // add a point to the front (false if dominated), ids of the points it dominates are removed & returned
+    bool Insert(const ParetoPoint &point, vector<int> *removedIds);
+
+    /* Properties */
+    vector<ParetoPoint> pointVector;    // sorted by area (only points of smaller area can dominate a point)
+
+}; /* class ParetoFront */
+
+#endif /* PARETOFRONT_H_ */
@@ -0,0 +1,64 @@
+/*********************************************************************************************
+* Definition of the Search Driver (NSGA-II over the hierarchy design params of the batch DSE)
+*********************************************************************************************/
+
+#ifndef SEARCHDRIVER_H_
+#define SEARCHDRIVER_H_
+
+#include <vector>
+#include <map>
+#include <random>
+#include "DesignSpace.h"
+#include "BatchEngine.h"
+
+using namespace std;
+
+/* gene of a design: option index of every knob
+ * (CIM array, numHierarchy, [numSubObjectRow, numSubObjectCol, outType, inType, busWidth, buType, coreBW] of each
+ *  non-top hierarchy, [outType, inType, busWidth, buType, coreBW] of the top hierarchy) */
+#define NUM_KNOB_HOBJ   7
+#define NUM_KNOB_TOP    5
+
+class SearchDriver {
+//private:
+public:
+    SearchDriver(DesignSpace *_designSpace, BatchEngine *_batchEngine);
+    virtual ~SearchDriver() {}
+
+    /* Functions */
+    // options of each knob of the gene (a single option: fixed knob)
+    void InitializeGene();
+    vector<int> RandomGene();
+    // knobs of the unused hierarchies are reset, so that a design has a single gene
+    void Canonicalize(vector<int> *gene) const;
+    // hierarchies of a single sub-object are skipped (as in the sweep)
+    bool IsValid(const vector<int> &gene) const;
+    vector<vector<int>> Decode(const vector<int> &gene, int *arrayIdx) const;
+    // design of a new gene added to the design space (designIdx)
+    int Propose(const vector<int> &gene);
+    // non-dominated fronts of the designs (feasible designs dominate the others), crowding distance in each front
+    void Sort(const vector<int> &designIdxVector, map<int, int> *rank, map<int, double> *crowding) const;
+    // NSGA-II environmental selection of the next population
+    vector<int> Select(const vector<int> &designIdxVector, int numSelect) const;
+    // offspring of the population (binary tournament, uniform crossover, mutation), screened by the surrogate
+    vector<int> MakeOffspring(const vector<int> &population);
+    vector<vector<int>> Screen(const vector<vector<int>> &candidateVector, int numSelect) const;
+    // knob options normalized to [0, 1] (input of the surrogate)
+    vector<double> Normalize(const vector<int> &gene) const;
+    // front of the proposed designs (the journal of a resumed run has designs proposed later)
+    void GetFront(ParetoFront *paretoFront) const;
+    void SaveProgress(int generation, const vector<int> &population) const;
+    void Run();
+
+    /* Properties */
+    DesignSpace *designSpace;
+    BatchEngine *batchEngine;
+    mt19937 rng;
+    vector<vector<int>> optionVector;       // values of each knob
+    int numVariable;                        // knobs with more than an option
+    map<vector<int>, int> archive;          // designIdx of each proposed gene
+    vector<vector<int>> geneVector;         // gene of each proposed design
+
+}; /* class SearchDriver */
+
+#endif /* SEARCHDRIVER_H_ */
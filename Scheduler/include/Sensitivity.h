@@ -0,0 +1,85 @@
+/*********************************************************************************************
+* Definition of the Sensitivity Analysis (finite differences of area/energy/latency over the design & Param knobs)
+*********************************************************************************************/
+
+#ifndef SENSITIVITY_H_
+#define SENSITIVITY_H_
+
+#include <vector>
+#include <string>
+#include "SimServer.h"
+#include "Evaluator.h"
+
+using namespace std;
+
+/* where the value of a knob lives */
+enum KnobType {
+    KNOB_DESIGNPARAM,   // column of a designParam row (the design is generated again)
+    KNOB_DELAYTOL,      // delaytolerance of a designArch row (structure & schedule of the base design)
+    KNOB_ARRAY,         // CIM array param (numRowCIMArray, numColCIMArray, levelOutput, numColMuxed)
+    KNOB_CLKFREQ        // clkFreq (structure & schedule of the base design)
+};
+
+struct SensitivityKnob {
+    string name;
+    KnobType type;
+    int hlevel;         // hierarchy of a design knob (1: lowest, 0: Param)
+    int idx;            // designParam column / arrayParam index
+    bool integer;
+    double baseValue;
+};
+
+struct SensitivityResult {
+    SensitivityKnob knob;
+    double value;               // perturbed value
+    string status;              // ok, unchanged (same designArch as the base), infeasible
+    string reason;              // DesignError reason of an infeasible perturbation
+    ServerResult result;
+    double dArea, dEnergy, dLatency;
+    bool absolute;              // d(metric)/metric per unit of the knob (knob of base value 0), otherwise per relative change
+    bool scheduleReused;
+    double verifyError;         // max relative difference to the evaluation from scratch (-1: not verified)
+};
+
+class Sensitivity {
+//private:
+public:
+    Sensitivity(SimServer *_simServer);
+    virtual ~Sensitivity() {}
+
+    /* Functions */
+    // base design (designParam of arch_generator_for_net) on the default precision & CIM array of the server
+    void Initialize(const string &_networkList, const vector<vector<int>> &_designParam, int _scheduler_type,
+                    double _step, bool _verify);
+    void InitializeKnob();
+    // perturbed value of a knob (sign: +1/-1), a relative step (at least 1 for integer knobs), absolute for 0
+    double Perturb(const SensitivityKnob &knob, int sign) const;
+    // design with a knob set to value, throws DesignError
+    // reuse: unchanged lower hierarchies from the subtree cache, structure & schedule of the base design if the knob
+    //        does not change them, otherwise the design is built & scheduled from the CIM array
+    ServerResult Evaluate(const SensitivityKnob &knob, double value, bool reuse, bool *scheduleReused, bool *unchanged);
+    void Run();
+    void Save(const string &filename) const;
+
+    /* Properties */
+    SimServer *simServer;
+    string networkList;
+    vector<vector<int>> designParam;
+    int scheduler_type;
+    double step;        // relative step of the forward difference
+    bool verify;        // every perturbation evaluated again from scratch
+
+    vector<SensitivityKnob> knobVector;
+    ServerResult baseResult;
+    vector<vector<double>> baseDesignArch;
+    Evaluator baseEvaluator;                // schedule of the base design
+    vector<SensitivityResult> resultVector;
+
+    /* Statistics */
+    int numEvaluated, numScheduleReused, numUnchanged, numInfeasible;
+    int numBuiltObject, numSharedObject;    // hierarchy objects of the perturbations
+    double baseTime, perturbTime;           // s
+
+}; /* class Sensitivity */
+
+#endif /* SENSITIVITY_H_ */
@@ -0,0 +1,119 @@
+/*********************************************************************************************
+* Definition of the Simulation Server (warm caches for design+network evaluation requests)
+*********************************************************************************************/
+
+#ifndef SIMSERVER_H_
+#define SIMSERVER_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <deque>
+#include <memory>
+#include "InputParameter.h"
+#include "Technology.h"
+#include "MemCell.h"
+#include "HierarchyRoot.h"
+#include "HierarchyDesign.h"
+#include "ArchGenerator.h"
+#include "Evaluator.h"
+#include "Json.h"
+
+using namespace std;
+
+/* network portfolio of the requests (structure with per-layer precision) */
+struct ServerNetwork {
+    vector<vector<vector<int>>> networkStructureVector;
+    vector<vector<vector<double>>> networkStructureVector_db;  // double format of the scheduler
+    vector<string> networkNames;
+    vector<double> networkWeights;
+    int synapseBit, numBitInput;    // precision of the hardware (max over the layers)
+};
+
+/* result of a design on a network portfolio */
+struct ServerResult {
+    vector<vector<int>> designArch;
+    double clkPeriod;   // s
+    double area;        // m^2
+    double energy;      // J (with leakage, weighted over the networks)
+    double latency;     // s
+    double power;       // W (average)
+    double topsw, tops;
+
+    /* breakdowns (chip: total, array, ADC, accum, buffer, ic, other / hObj: total, subObject, accum, buffer, ic, other) */
+    vector<double> chipAreaVector, chipLatencyVector, chipEnergyVector;    // m^2, s, J
+    vector<vector<double>> areaVector2, latencyVector2, energyVector2;     // per hierarchy (hlevel 1 -> top)
+
+    /* metrics of each network (energy_with_leakage [J], latency [s], topsw, tops) */
+    vector<string> networkNames;
+    vector<vector<double>> networkMetric;
+
+    /* caches used */
+    bool resultHit, rootHit;
+    int numShared;      // hierarchy objects taken from a cached design
+};
+
+class SimServer {
+//private:
+public:
+    SimServer(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell);
+    virtual ~SimServer() {}
+    InputParameter& inputParameter;
+    Technology& tech;
+    MemCell& cell;
+
+    /* Functions */
+    // default precision & scheduler of the requests, Param as set up by the program (array, clkFreq, overrides)
+    void Initialize(int _synapseBit, int _numBitInput, int _scheduler_type);
+    // one request line -> one response line (errors are answered, never thrown)
+    string HandleRequest(const string &line);
+    JsonValue Evaluate(const JsonValue &request);
+    JsonValue Stats() const;
+
+    // evaluation of a design (arrayParam: numRowCIMArray, numColCIMArray, levelOutput, numColMuxed)
+    // cache: false to build the design from the warm root only (no cached result or subtree)
+    ServerResult EvaluateDesign(const string &networkList, int synapseBit, int numBitInput, int scheduler_type,
+                                const vector<int> &arrayParam, const vector<vector<int>> &designParam, bool cache);
+
+    // Param of the request (precision, CIM array, clkFreq) & its warm root (rootKey of the subtree cache)
+    const ServerNetwork& Prepare(const string &networkList, int synapseBit, int numBitInput, const vector<int> &arrayParam,
+                                 HierarchyRoot **hRoot, string *rootKey, bool *rootHit);
+    // evaluation of a generated designArch on a prepared root (no result cache)
+    // scheduleBase: mapping reused instead of Scheduling (design of the same structure), evaluator: kept by the caller
+    ServerResult EvaluateArch(const ServerNetwork &network, HierarchyRoot *hRoot, const string &rootKey,
+                              const vector<vector<double>> &designArch, int scheduler_type, bool cache,
+                              const Evaluator *scheduleBase, Evaluator *evaluator);
+
+    // portfolio read & precision set once per (network list, precision)
+    const ServerNetwork& GetNetwork(const string &networkList, int synapseBit, int numBitInput);
+    // Param of the CIM array & precision (technology & HierarchyRoot initialized once per key)
+    HierarchyRoot* GetRoot(const string &rootKey, bool *hit);
+    // design with the longest designArch prefix in the subtree cache (NULL if none), numShared: levels in common
+    shared_ptr<const HierarchyDesign> FindSubtree(const string &rootKey, const vector<vector<double>> &designArch,
+                                                  int *numShared) const;
+    void AddSubtree(const string &rootKey, const shared_ptr<const HierarchyDesign> &hDesign);
+
+    /* Properties */
+    int synapseBit, numBitInput;    // default precision of the requests
+    int scheduler_type;             // default scheduler of the requests
+    int cellBit;                    // memory precision before the requests (lowered to the synapse precision)
+    double clkFreq;                 // clock frequency before the design (lowered by the clock period of each CIM array, part of the root key)
+    vector<int> arrayParam;         // default CIM array of the requests
+    int maxCachedDesign;            // designs kept in the subtree cache (oldest dropped first)
+    bool shutdown;
+
+    /* Caches */
+    map<string, ServerNetwork> networkCache;
+    map<string, unique_ptr<HierarchyRoot>> rootCache;
+    map<string, shared_ptr<const HierarchyDesign>> subtreeCache; // root & designArch prefix -> design
+    deque<pair<string, shared_ptr<const HierarchyDesign>>> subtreeOrder; // designs in the subtree cache (insertion order)
+    map<string, ServerResult> resultCache;                      // network, root & design -> result
+
+    /* Statistics */
+    int numRequest, numEvaluated, numResultHit, numRootHit, numRootMiss, numSharedObject, numBuiltObject, numError;
+
+    ArchGenerator archGenerator;
+
+}; /* class SimServer */
+
+#endif /* SIMSERVER_H_ */
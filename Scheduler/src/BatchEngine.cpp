@@ -0,0 +1,850 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include "BatchEngine.h"
+#include "HierarchyDesign.h"
+#include "Evaluator.h"
+#include "Param.h"
+#include "DesignError.h"
+#include "formula.h"
+#include "util.h"
+
+extern Param *param;
+
+BatchEngine::BatchEngine(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell):
+                        inputParameter(_inputParameter), tech(_tech), cell(_cell),
+                        archGenerator(_inputParameter, _tech, _cell) {
+    journal = NULL;
+    worker = false;
+    resumed = false;
+}
+
+void BatchEngine::Initialize(const DesignSpace *_designSpace, const vector<vector<vector<int>>> &_networkStructureVector,
+                             const vector<string> &_networkNames, const vector<double> &_networkWeights,
+                             int _scheduler_type, const string &_basefolder) {
+    designSpace = _designSpace;
+    networkStructureVector = _networkStructureVector;
+    networkNames = _networkNames;
+    networkWeights = _networkWeights;
+    scheduler_type = _scheduler_type;
+    basefolder = _basefolder;
+    clkFreq = param->clkFreq;
+
+    archGenerator.Initialize(NULL, networkStructureVector, scheduler_type);
+    networkStructureVector_db = archGenerator.networkStructureVector;
+
+    // operations & normalized weights of the networks (for the bounds of the weighted aggregate)
+    double totalWeight = 0;
+    for ( auto weight : networkWeights ) {
+        totalWeight += weight;
+    }
+    networkComputation.clear();
+    for ( int networkIdx=0; networkIdx < networkStructureVector_db.size(); networkIdx++ ) {
+        const vector<vector<double>> &networkStructure = networkStructureVector_db[networkIdx];
+        double numComputation = 0;
+        for (int i=0; i<networkStructure.size(); i++) {
+            numComputation += 2*( networkStructure[i][0] * networkStructure[i][1] * networkStructure[i][2] 
+                                * networkStructure[i][3] * networkStructure[i][4] * networkStructure[i][5] );
+        }
+        networkComputation.push_back(numComputation);
+        networkWeights[networkIdx] /= totalWeight;
+    }
+
+    paretoFront.Clear();
+    paretoResult.clear();
+    numEvaluated = 0;
+    numInfeasible = 0;
+    numPruned = 0;
+    numFailed = 0;
+    numDuplicate = 0;
+    designKeyMap.clear();
+
+    // folders of the results
+    mkdir(basefolder.c_str(), 0755);
+    for ( auto folder : {"designParam", "designArch", "performanceChip", "performanceHObj"} ) {
+        mkdir((basefolder + "/" + folder).c_str(), 0755);
+    }
+}
+
+HierarchyRoot* BatchEngine::GetRoot(int arrayIdx) {
+    auto it = rootCache.find(arrayIdx);
+    if ( it == rootCache.end() ) {
+        designSpace->ApplyArrayParam(arrayIdx);
+        param->clkFreq = clkFreq;
+        unique_ptr<HierarchyRoot> hRoot(new HierarchyRoot(inputParameter, tech, cell));
+        hRoot->Initialize();
+        it = rootCache.insert(make_pair(arrayIdx, move(hRoot))).first;
+    }
+    return it->second.get();
+}
+
+DesignResult BatchEngine::EvaluateDesign(int designIdx) {
+    try {
+        return SimulateDesign(designIdx);
+    } catch ( const DesignError &e ) {
+        // invalid design (e.g. mapping overflows the hierarchy): infeasible with the reason code of the error
+        DesignResult result;
+        result.designIdx = designIdx;
+        result.arrayIdx = designSpace->GetArrayIdx(designIdx);
+        result.numHierarchy = designSpace->GetDesignParam(designIdx).size();
+        result.status = DESIGN_INFEASIBLE;
+        result.reason = e.reason;
+        result.area = result.energy = result.latency = result.power = result.topsw = result.tops = 0;
+        result.energyBound = result.latencyBound = result.powerBound = result.topsBound = 0;
+        printf("[designIdx: %8d] infeasible (%s): %s\n", designIdx, e.reason.c_str(), e.what());
+        RecordResult(result);
+        return result;
+    }
+}
+
+DesignResult BatchEngine::SimulateDesign(int designIdx) {
+
+    /* CIM array (params of the array are used by the generator & scheduler) */
+    int arrayIdx = designSpace->GetArrayIdx(designIdx);
+    HierarchyRoot *hRoot = GetRoot(arrayIdx);
+    designSpace->ApplyArrayParam(arrayIdx);
+    param->clkFreq = clkFreq;
+
+    /* generate architecture with design params */
+    vector<vector<int>> designParam = designSpace->GetDesignParam(designIdx);
+    archGenerator.hRoot = hRoot;
+    vector<vector<int>> designArch = archGenerator.Generate(designParam);
+
+    /* Architecture Design Initialization */
+    vector<vector<double>> designArch_db;
+    for ( auto &designHObj : designArch ) {
+        designArch_db.push_back(vector<double>(designHObj.begin(), designHObj.end()));
+    }
+    int numHierarchy = designArch_db.size();
+    HierarchyDesign hDesign(inputParameter, tech, cell, hRoot, designArch_db);
+    hDesign.Initialize(param->clkFreq);
+    vector<HierarchyObject*> &hObjectVector = hDesign.hObjectVector;
+    HierarchyObject *lastObject = hDesign.GetTop();
+
+    /* Equivalent design completed already (same HierarchyObjects on the same CIM array) */
+    string designKey = GetDesignKey(arrayIdx, hObjectVector);
+    auto it = designKeyMap.find(designKey);
+    if ( it != designKeyMap.end() ) {
+        DesignResult result = it->second;
+        result.designIdx = designIdx;
+        result.status = DESIGN_DUPLICATE;
+        result.reason = to_string(it->second.designIdx);
+        RecordResult(result);
+        printf("[designIdx: %8d] duplicate of %d\n", designIdx, it->second.designIdx);
+        return result;
+    }
+
+    /* Architecture CLK Period Calculation */
+    double clkPeriod = 0;
+    hRoot->CalculateLatency(true, (double)hRoot->numRow, (double)hRoot->numCol, 1, 1, 1, &clkPeriod);
+    if ( param->clkFreq > 1/clkPeriod ) {
+        param->clkFreq = 1/clkPeriod;
+    }
+
+    /* Get Architecture area information */
+    vector<double> chipAreaVector = lastObject->areaVector;
+    vector<vector<double>> chipAreaVector2;
+    for (int h=0; h < numHierarchy; h++) {
+        chipAreaVector2.push_back(hObjectVector.at(h)->areaVector2);
+    }
+
+    DesignResult result;
+    result.designIdx = designIdx;
+    result.arrayIdx = arrayIdx;
+    result.numHierarchy = numHierarchy;
+    result.designKey = designKey;
+    result.area = chipAreaVector[0];
+    result.status = DESIGN_EVALUATED;
+    result.energy = result.latency = result.power = result.topsw = result.tops = 0;
+
+    /* Pruning before scheduling (bounds violate a constraint or are dominated by the Pareto set) */
+    CalculateBound(hRoot, hObjectVector, clkPeriod, &result);
+    result.reason = CheckConstraint(result, true);
+    if ( result.reason.empty() && designSpace->pruneDominated
+         && paretoFront.IsDominated({designIdx, result.area, result.energyBound, result.latencyBound}) ) {
+        result.reason = "dominated";
+    }
+    if ( !result.reason.empty() ) {
+        result.status = DESIGN_PRUNED;
+        RecordResult(result);
+        printf("[designIdx: %8d] pruned (%s): %10.4e mm^2, energy >= %10.4e pJ, latency >= %10.4e ns, TOPS <= %10.4f\n",
+               designIdx, result.reason.c_str(), result.area*1e6, result.energyBound*1e12, result.latencyBound*1e9,
+               result.topsBound);
+        return result;
+    }
+
+    /* Network Scheduling & Performance */
+    Evaluator evaluator;
+    evaluator.Initialize(hRoot, hObjectVector, clkPeriod);
+    for ( int networkIdx=0; networkIdx < networkStructureVector_db.size(); networkIdx++ ) {
+        evaluator.AddNetwork(networkNames[networkIdx], networkStructureVector_db[networkIdx], networkWeights[networkIdx]);
+    }
+    evaluator.Scheduling(scheduler_type);
+    evaluator.CalculatePerformance();
+
+    result.energy = evaluator.dynamicEnergy + evaluator.leakageEnergy;
+    result.latency = evaluator.latency * clkPeriod;
+    result.power = result.energy / (evaluator.imageLatency * clkPeriod);
+    result.topsw = evaluator.topsw;
+    result.tops = evaluator.tops;
+    for ( auto &network : evaluator.networkVector ) {
+        result.networkMetric.push_back({(network.chipEnergyVector[0]+network.chipLeakageEnergy)*1e12,
+                                        (network.latency*clkPeriod)*1e12, network.topsw, network.tops});
+    }
+
+    // constraints on the results
+    result.reason = CheckConstraint(result, false);
+    if ( !result.reason.empty() ) {
+        result.status = DESIGN_INFEASIBLE;
+    }
+    bool onFront = RecordResult(result);
+
+    printf("[designIdx: %8d] %-12s %10.4e mm^2 %10.4f TOPS/W %10.4f TOPS\n", designIdx,
+           ("array " + to_string(param->numRowCIMArray) + "x" + to_string(param->numColCIMArray)).c_str(),
+           result.area*1e6, result.topsw, result.tops);
+
+    // full breakdowns only for the designs on the Pareto front (removed once dominated)
+    if ( !designSpace->saveAll && !onFront ) {
+        return result;
+    }
+
+    /* Save Simulation Results (same files as main_iter) */
+    saveIntVector2(basefolder + "/designParam/designParam_" + to_string(designIdx) + ".csv", &designParam);
+    saveIntVector2(basefolder + "/designArch/designArch_" + to_string(designIdx) + ".csv", &designArch);
+    double clkPeriod_ns = clkPeriod * 1e9;
+    string indicator_header = "IC,OC,Wbit,Abit,numHierarchy,busType";
+    string indicator = to_string((int)networkStructureVector_db[0][0][2]) + "," + to_string((int)networkStructureVector_db[0][0][5]) + ","
+                       + to_string(param->synapseBit) + "," + to_string(param->numBitInput) + "," + to_string(numHierarchy+1);
+    int busType = 0; // 0 - bus, 1 - sys1, 2 - sys2
+    for ( int h=0; h < numHierarchy; h++ ) {
+        if ( hObjectVector[h]->interConnect->inType == 1 ) {
+            busType = h + 1;
+        }
+    }
+    indicator += "," + to_string(busType);
+
+    string filename = basefolder + "/performanceHObj/performanceHObj_" + to_string(designIdx) + ".csv";
+    savePerformanceVector2(0, filename, indicator_header, indicator, &evaluator.networkLatencyVector2, clkPeriod_ns, numHierarchy, 1);
+    savePerformanceVector2(1, filename, indicator_header, indicator, &evaluator.networkEnergyVector2, 1e12, numHierarchy, 1);
+    vector<vector<double>> newAreaVector2 = updateAreaVector2(&chipAreaVector2, chipAreaVector[0], numHierarchy, &hObjectVector);
+    savePerformanceVector2(2, filename, indicator_header, indicator, &newAreaVector2, 1e12, numHierarchy, 0);
+
+    filename = basefolder + "/performanceChip/performanceChip_" + to_string(designIdx) + ".csv";
+    savePerformanceVector(0, filename, indicator_header, indicator, &evaluator.chipLatencyVector, clkPeriod_ns);
+    savePerformanceVector(1, filename, indicator_header, indicator, &evaluator.chipEnergyVector, 1e12);
+    savePerformanceVector(2, filename, indicator_header, indicator, &chipAreaVector, 1e12);
+
+    if ( !designSpace->saveAll ) {
+        return result;
+    }
+    savePerformanceMetric(designIdx, basefolder + "/energy.csv", numHierarchy, evaluator.dynamicEnergy*1e12);
+    savePerformanceMetric(designIdx, basefolder + "/energy_with_leakage.csv", numHierarchy, result.energy*1e12);
+    savePerformanceMetric(designIdx, basefolder + "/latency.csv", numHierarchy, result.latency*1e12);
+    savePerformanceMetric(designIdx, basefolder + "/topsw.csv", numHierarchy, result.topsw);
+    savePerformanceMetric(designIdx, basefolder + "/tops.csv", numHierarchy, result.tops);
+    savePerformanceMetric(designIdx, basefolder + "/area.csv", numHierarchy, result.area*1e12);
+
+    if ( evaluator.networkVector.size() > 1 ) {
+        for ( int networkIdx=0; networkIdx < evaluator.networkVector.size(); networkIdx++ ) {
+            savePortfolioMetric(designIdx, basefolder + "/portfolio.csv", numHierarchy, evaluator.networkVector[networkIdx].name,
+                                evaluator.networkVector[networkIdx].weight, result.networkMetric[networkIdx]);
+        }
+    }
+
+    return result;
+
+}
+
+bool BatchEngine::RecordResult(const DesignResult &result) {
+    bool onFront = false;
+    if ( result.status == DESIGN_PRUNED ) {
+        numPruned++;
+    } else if ( result.status == DESIGN_FAILED ) {
+        numFailed++;
+    } else if ( result.status == DESIGN_DUPLICATE ) {
+        numDuplicate++;
+    } else if ( result.status == DESIGN_INFEASIBLE ) {
+        numInfeasible++;
+    } else {
+        numEvaluated++;
+        onFront = UpdatePareto(result);
+    }
+    if ( !result.designKey.empty() && (result.status != DESIGN_DUPLICATE) ) {
+        designKeyMap.insert(make_pair(result.designKey, result));
+    }
+    if ( !worker ) {
+        SaveDesignSummary(result);
+        if ( designSpace->searchPopulation > 0 ) {
+            resultMap[result.designIdx] = result;
+        }
+    }
+    return onFront;
+}
+
+/* CIM array, status & metrics of the design (metrics in the units of the metric files, empty if pruned) */
+void BatchEngine::SaveDesignSummary(const DesignResult &result) {
+    const vector<int> &arrayParam = designSpace->arrayParamVector[result.arrayIdx];
+    string filename = basefolder + "/designs.csv";
+    bool fileExist = ( access(filename.c_str(), F_OK) != -1 );
+    ofstream fout(filename, ios::app);
+    if ( !fileExist ) {
+        fout << "archIdx,numHierarchy,numRowCIMArray,numColCIMArray,levelOutput,numColMuxed,status,reason,"
+             << "area,energy_with_leakage,latency,topsw,tops,power\n";
+    }
+    fout << result.designIdx << "," << result.numHierarchy << "," << arrayParam[0] << "," << arrayParam[1] << ","
+         << arrayParam[2] << "," << arrayParam[3] << "," << result.status << "," << result.reason << ",";
+    if ( result.networkMetric.empty() ) { // not simulated
+        fout << result.area*1e12 << ",,,,,\n";
+    } else {
+        fout << result.area*1e12 << "," << result.energy*1e12 << "," << result.latency*1e12 << ","
+             << result.topsw << "," << result.tops << "," << result.power << "\n";
+    }
+}
+
+/* designs on the final Pareto front (sorted by area) & their network metrics */
+void BatchEngine::SavePareto() {
+    // written to a temporary file & renamed, so that a checkpoint never leaves a partial file
+    string filename = basefolder + "/pareto.csv";
+    ofstream fout(filename + ".tmp");
+    fout << "archIdx,numHierarchy,area,energy_with_leakage,latency,topsw,tops,power\n";
+    for ( auto &point : paretoFront.pointVector ) {
+        const DesignResult &result = paretoResult[point.id];
+        fout << result.designIdx << "," << result.numHierarchy << "," << result.area*1e12 << "," << result.energy*1e12 << ","
+             << result.latency*1e12 << "," << result.topsw << "," << result.tops << "," << result.power << "\n";
+    }
+    fout.close();
+    rename((filename + ".tmp").c_str(), filename.c_str());
+
+    // portfolio.csv is written per design with saveAll
+    if ( designSpace->saveAll || (networkNames.size() <= 1) ) {
+        return;
+    }
+    filename = basefolder + "/portfolio.csv";
+    remove((filename + ".tmp").c_str());
+    for ( auto &point : paretoFront.pointVector ) {
+        const DesignResult &result = paretoResult[point.id];
+        for ( int networkIdx=0; networkIdx < networkNames.size(); networkIdx++ ) {
+            savePortfolioMetric(result.designIdx, filename + ".tmp", result.numHierarchy, networkNames[networkIdx],
+                                networkWeights[networkIdx], result.networkMetric[networkIdx]);
+        }
+    }
+    rename((filename + ".tmp").c_str(), filename.c_str());
+}
+
+/* Journal: a header with the design space, constraints, networks, precision, scheduler & parameter overrides,
+ * then a record per completed design
+ * (designIdx, arrayIdx, numHierarchy, status, reason, designKey, area, energy, latency, power, topsw, tops, bounds, metrics of each network) */
+void BatchEngine::OpenJournal() {
+    string filename = basefolder + "/journal.csv";
+    ostringstream oss;
+    oss << "# " << designSpace->Describe();
+    for ( int networkIdx=0; networkIdx < networkNames.size(); networkIdx++ ) {
+        oss << "," << networkNames[networkIdx] << ":" << networkWeights[networkIdx];
+    }
+    oss << ",wbits=" << param->synapseBit << ";abits=" << param->numBitInput << ";scheduler_type=" << scheduler_type << ";params=";
+    for ( int argIdx=0; argIdx < param->paramArgs.size(); argIdx++ ) {
+        oss << (( argIdx == 0 )? "" : " ") << param->paramArgs[argIdx];
+    }
+    string header = oss.str();
+    completed.assign(designSpace->Size(), 0);
+    numCompleted = 0;
+
+    // designs.csv is rebuilt from the journal
+    remove((basefolder + "/designs.csv").c_str());
+
+    ifstream fin(filename);
+    bool fileExist = fin.is_open();
+    long length = 0;    // length of the valid records
+    if ( fileExist ) {
+        string line;
+        if ( getline(fin, line) && !fin.eof() ) {
+            if ( line != header ) {
+                cerr << "[Error] journal of " << basefolder << " is from another design space or run settings (" << line << ")" << endl;
+                exit(-1);
+            }
+            length = header.size() + 1;
+            DesignResult result;
+            while ( getline(fin, line) && !fin.eof() ) { // the last line without newline is a partial record
+                if ( !ParseJournal(line, &result) || completed[result.designIdx] ) {
+                    break;
+                }
+                length += line.size() + 1;
+                completed[result.designIdx] = 1;
+                numCompleted++;
+                RecordResult(result);
+            }
+        }
+        fin.close();
+        // drop the partial record of an interrupted run
+        if ( truncate(filename.c_str(), length) != 0 ) {
+            cerr << "[Error] journal " << filename << " cannot be truncated" << endl;
+            exit(-1);
+        }
+    }
+
+    journal = fopen(filename.c_str(), "a");
+    if ( journal == NULL ) {
+        cerr << "[Error] journal " << filename << " cannot be opened" << endl;
+        exit(-1);
+    }
+    if ( length == 0 ) {
+        fprintf(journal, "%s\n", header.c_str());
+        fflush(journal);
+    }
+}
+
+bool BatchEngine::ParseJournal(const string &line, DesignResult *result) const {
+    vector<string> fields;
+    string field;
+    istringstream iss(line);
+    while ( getline(iss, field, ',') ) {
+        fields.push_back(field);
+    }
+    if ( !line.empty() && (line.back() == ',') ) {
+        fields.push_back("");
+    }
+    if ( fields.size() != 16 + 4*networkNames.size() ) {
+        return false;
+    }
+    bool simulated = !fields.back().empty();
+    vector<double> values;
+    for ( int i=0; i < fields.size(); i++ ) {
+        if ( (i == 4) || (i == 5) ) { continue; } // reason, designKey
+        if ( (i >= 16) && !simulated ) { break; }
+        char *end;
+        values.push_back(strtod(fields[i].c_str(), &end));
+        if ( fields[i].empty() || (*end != '\0') ) {
+            return false;
+        }
+    }
+    result->designIdx = (int)values[0];
+    if ( (result->designIdx < 0) || (result->designIdx >= designSpace->Size()) ) {
+        return false;
+    }
+    result->arrayIdx = (int)values[1];
+    if ( (result->arrayIdx < 0) || (result->arrayIdx >= designSpace->arrayParamVector.size()) ) {
+        return false;
+    }
+    result->numHierarchy = (int)values[2];
+    result->status = (int)values[3];
+    result->reason = fields[4];
+    result->designKey = fields[5];
+    result->area = values[4];
+    result->energy = values[5];
+    result->latency = values[6];
+    result->power = values[7];
+    result->topsw = values[8];
+    result->tops = values[9];
+    result->energyBound = values[10];
+    result->latencyBound = values[11];
+    result->powerBound = values[12];
+    result->topsBound = values[13];
+    result->networkMetric.clear();
+    for ( int networkIdx=0; simulated && (networkIdx < networkNames.size()); networkIdx++ ) {
+        result->networkMetric.push_back(vector<double>(values.begin() + 14 + 4*networkIdx, values.begin() + 18 + 4*networkIdx));
+    }
+    return true;
+}
+
+void BatchEngine::SaveJournal(const DesignResult &result) {
+    fprintf(journal, "%d,%d,%d,%d,%s,%s,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g",
+            result.designIdx, result.arrayIdx, result.numHierarchy, result.status, result.reason.c_str(),
+            result.designKey.c_str(), result.area, result.energy,
+            result.latency, result.power, result.topsw, result.tops, result.energyBound, result.latencyBound,
+            result.powerBound, result.topsBound);
+    // metrics of each network (empty if not simulated)
+    for ( int networkIdx=0; networkIdx < networkNames.size(); networkIdx++ ) {
+        for ( int i=0; i < 4; i++ ) {
+            if ( result.networkMetric.empty() ) {
+                fprintf(journal, ",");
+            } else {
+                fprintf(journal, ",%.17g", result.networkMetric[networkIdx][i]);
+            }
+        }
+    }
+    fprintf(journal, "\n");
+    fflush(journal);
+}
+
+void BatchEngine::CommitResult(const DesignResult &result) {
+    SaveJournal(result);
+    completed[result.designIdx] = 1;
+    numCompleted++;
+    if ( (designSpace->checkpointInterval > 0) && (++numSinceCheckpoint >= designSpace->checkpointInterval) ) {
+        Checkpoint();
+        numSinceCheckpoint = 0;
+    }
+}
+
+void BatchEngine::Checkpoint() {
+    fsync(fileno(journal));
+    SavePareto();
+    string filename = basefolder + "/checkpoint.csv";
+    ofstream fout(filename + ".tmp");
+    fout << "numDesigns,numCompleted,numEvaluated,numInfeasible,numPruned,numFailed,numDuplicate,numPareto\n";
+    fout << designSpace->Size() << "," << numCompleted << "," << numEvaluated << "," << numInfeasible << ","
+         << numPruned << "," << numFailed << "," << numDuplicate << "," << paretoFront.Size() << "\n";
+    fout.close();
+    rename((filename + ".tmp").c_str(), filename.c_str());
+}
+
+void BatchEngine::CalculateBound(HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector,
+                                 double clkPeriod, DesignResult *result) {
+
+    // number of CIM arrays of the design
+    double numArray = 1;
+    for ( auto hObject : hObjectVector ) {
+        numArray *= hObject->numSubObject;
+    }
+    // leakage power (idle units can be power gated)
+    double leakage = param->powerGating? 0 : hObjectVector.back()->leakage;
+
+    double numComputation = 0, imageLatency = 0, energy = 0;
+    for ( int networkIdx=0; networkIdx < archGenerator.networkInfoReadVector.size(); networkIdx++ ) {
+        // CIM array work of the mapping (the mapping of the generator has the same array operations)
+        const InfoReadTable &networkInfoRead = archGenerator.networkInfoReadVector[networkIdx];
+        double arrayLatency = 0, arrayEnergy = 0;
+        map<int, double> layerLatency; // longest operation of a single array per layer
+        for ( int infoIdx=0; infoIdx < networkInfoRead.Size(); infoIdx++ ) {
+            if ( networkInfoRead.header[infoIdx].type != INFOREAD_ROOT ) { continue; }
+            vector<double> infoReadHRoot = networkInfoRead.GetInfoReadHRoot(infoIdx);
+            hRoot->CalculateLatency(infoReadHRoot);
+            arrayLatency += hRoot->latencyVector[0];
+            double &maxLatency = layerLatency[networkInfoRead.header[infoIdx].layerIdx];
+            maxLatency = MAX(maxLatency, hRoot->latencyVector[0]);
+            hRoot->CalculatePower(infoReadHRoot);
+            arrayEnergy += hRoot->readDynamicEnergyVector[0];
+        }
+        // every array operation has to be done, at best evenly spread over the arrays
+        double latency = arrayLatency / numArray;
+        // the operation of a single array cannot be split (unless the replicas are re-balanced),
+        // and the layers run one after another without pipelining/batching
+        if ( param->replicaBudget == 0 ) {
+            double criticalLatency = 0;
+            for ( auto &layer : layerLatency ) {
+                if ( param->pipeline || (param->batchSize > 1) ) {
+                    criticalLatency = MAX(criticalLatency, layer.second);
+                } else {
+                    criticalLatency += layer.second;
+                }
+            }
+            latency = MAX(latency, criticalLatency);
+        }
+        double weight = networkWeights[networkIdx];
+        numComputation += weight * networkComputation[networkIdx];
+        imageLatency += weight * latency;
+        energy += weight * ( arrayEnergy + leakage * latency * clkPeriod );
+    }
+
+    result->latencyBound = imageLatency * clkPeriod;
+    result->energyBound = energy;
+    result->powerBound = leakage;
+    result->topsBound = numComputation / (imageLatency * clkPeriod) / 1e12;
+
+}
+
+/* CIM array & the HierarchyObjects of each hierarchy as the mapping and circuit modules see them
+ * (numSubObject, numRow/numCol, numInC/numOutC, DE, IC & BU), so designs with the same key have the same results. */
+string BatchEngine::GetDesignKey(int arrayIdx, const vector<HierarchyObject*> &hObjectVector) const {
+    ostringstream designKey;
+    designKey.precision(10);
+    designKey << arrayIdx;
+    for ( auto hObject : hObjectVector ) {
+        const InterConnect *IC = hObject->interConnect.get();
+        const BufferUnit *BU = hObject->bufferUnit.get();
+        vector<double> keyVector = {(double)hObject->numSubObjectRow, (double)hObject->numSubObjectCol,
+                                    (double)hObject->numRow, (double)hObject->numCol,
+                                    (double)hObject->numInC, (double)hObject->numOutC};
+        keyVector.insert(keyVector.end(), hObject->designDE.begin(), hObject->designDE.end());
+        // inBusWidth of a 2D mesh is the flit size, the inType param is its number of ports
+        keyVector.insert(keyVector.end(), {IC->delaytolerance, (double)IC->outType, IC->outBusWidth, (double)IC->inType,
+                                           IC->inBusWidth, (double)((IC->outType == 2)? IC->numPort : 0)});
+        keyVector.insert(keyVector.end(), {(double)BU->buType, (double)BU->outBUSize, (double)BU->outBUCoreBW,
+                                           (double)BU->numOutBUCore, (double)BU->inBUSize, (double)BU->inBUCoreBW,
+                                           (double)BU->numInBUCore});
+        designKey << ";";
+        for ( int i=0; i < keyVector.size(); i++ ) {
+            designKey << (( i == 0 )? "" : " ") << keyVector[i];
+        }
+    }
+    return designKey.str();
+}
+
+string BatchEngine::CheckConstraint(const DesignResult &result, bool bound) const {
+    double tops = bound? result.topsBound : result.tops;
+    double power = bound? result.powerBound : result.power;
+    if ( (designSpace->maxArea > 0) && (result.area*1e6 > designSpace->maxArea) ) {
+        return "area";
+    }
+    if ( (designSpace->minTOPS > 0) && (tops < designSpace->minTOPS) ) {
+        return "tops";
+    }
+    if ( (designSpace->maxPower > 0) && (power > designSpace->maxPower) ) {
+        return "power";
+    }
+    return "";
+}
+
+bool BatchEngine::UpdatePareto(const DesignResult &result) {
+    vector<int> removedIds;
+    if ( !paretoFront.Insert({result.designIdx, result.area, result.energy, result.latency}, &removedIds) ) {
+        return false;
+    }
+    for ( auto designIdx : removedIds ) {
+        paretoResult.erase(designIdx);
+        if ( !designSpace->saveAll && !worker ) {
+            RemoveBreakdown(designIdx);
+        }
+    }
+    paretoResult[result.designIdx] = result;
+    return true;
+}
+
+void BatchEngine::RemoveBreakdown(int designIdx) {
+    for ( auto folder : {"designParam", "designArch", "performanceChip", "performanceHObj"} ) {
+        string filename = basefolder + "/" + folder + "/" + folder + "_" + to_string(designIdx) + ".csv";
+        remove(filename.c_str());
+    }
+}
+
+void BatchEngine::Run() {
+    printf("---------- Batch DSE: %d designs (%d CIM arrays x %d hierarchy designs) ----------\n",
+           designSpace->Size(), (int)designSpace->arrayParamVector.size(), (int)designSpace->hierarchyDesignVector.size());
+    Start();
+    vector<int> designIdxVector;
+    for ( int designIdx=0; designIdx < designSpace->Size(); designIdx++ ) {
+        designIdxVector.push_back(designIdx);
+    }
+    EvaluateBatch(designIdxVector);
+    Finish();
+}
+
+void BatchEngine::Start() {
+    numSinceCheckpoint = 0;
+    resultMap.clear();
+    OpenJournal();
+    MergeShards(true);  // shards of an interrupted run with worker processes
+    resumed = ( numCompleted > 0 );
+    if ( resumed ) {
+        printf("---------- Batch DSE: resume with %d designs of the journal ----------\n", numCompleted);
+    }
+}
+
+void BatchEngine::EvaluateBatch(const vector<int> &designIdxVector) {
+    vector<int> pendingVector;
+    for ( auto designIdx : designIdxVector ) {
+        if ( !completed[designIdx] ) {
+            pendingVector.push_back(designIdx);
+        }
+    }
+    if ( pendingVector.empty() ) {
+        return;
+    }
+
+    if ( designSpace->numWorker > 0 ) {
+        RunWorkers(pendingVector);
+    } else {
+        for ( auto designIdx : pendingVector ) {
+            // breakdowns left by the design in progress when the run was interrupted
+            if ( resumed ) {
+                RemoveBreakdown(designIdx);
+            }
+            CommitResult(EvaluateDesign(designIdx));
+        }
+    }
+}
+
+void BatchEngine::Finish() {
+    if ( designSpace->numWorker == 0 ) {
+        printf("---------- Batch DSE: %d CIM arrays built ----------\n", (int)rootCache.size());
+    }
+    printf("---------- Batch DSE: %d evaluated, %d infeasible, %d pruned, %d failed, %d Pareto designs ----------\n",
+           numEvaluated, numInfeasible, numPruned, numFailed, paretoFront.Size());
+    if ( numDuplicate > 0 ) {
+        printf("---------- Batch DSE: %d duplicates of a completed design ----------\n", numDuplicate);
+    }
+    Checkpoint();
+    fclose(journal);
+    journal = NULL;
+}
+
+/* Coordinator: workers pull the pending designs from a queue in shared memory
+ * (queue[0]: next pending design, queue[1+workerIdx]: design in progress of the worker, -1 if none) */
+void BatchEngine::RunWorkers(const vector<int> &pendingVector) {
+    int numWorker = designSpace->numWorker;
+    int *queue = (int*)mmap(NULL, sizeof(int)*(1+numWorker), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if ( queue == MAP_FAILED ) {
+        cerr << "[Error] work queue of the workers cannot be allocated" << endl;
+        exit(-1);
+    }
+    queue[0] = 0;
+    mkdir((basefolder + "/shards").c_str(), 0755);
+
+    printf("---------- Batch DSE: %d designs on %d worker processes ----------\n", (int)pendingVector.size(), numWorker);
+    vector<pid_t> workerPid;
+    for ( int workerIdx=0; workerIdx < numWorker; workerIdx++ ) {
+        workerPid.push_back(SpawnWorker(workerIdx, queue, pendingVector));
+    }
+
+    int numAlive = numWorker;
+    while ( numAlive > 0 ) {
+        int status;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if ( pid <= 0 ) {
+            MergeShards(false);
+            usleep(100000);
+            continue;
+        }
+        int workerIdx = find(workerPid.begin(), workerPid.end(), pid) - workerPid.begin();
+        if ( workerIdx == numWorker ) { continue; }
+        MergeShards(false);
+
+        if ( WIFEXITED(status) && (WEXITSTATUS(status) == 0) ) {
+            numAlive--;
+            workerPid[workerIdx] = -1;
+            continue;
+        }
+        // design in progress of a dead worker is reported as failed (not retried on resume)
+        int designIdx = queue[1+workerIdx];
+        queue[1+workerIdx] = -1;
+        if ( (designIdx >= 0) && !completed[designIdx] ) {
+            string reason = WIFEXITED(status)? "exit " + to_string(WEXITSTATUS(status)): "signal " + to_string(WTERMSIG(status));
+            printf("[designIdx: %8d] failed (worker %d, %s)\n", designIdx, (int)pid, reason.c_str());
+            FailDesign(designIdx, reason);
+        }
+        // replace the worker while designs are left
+        if ( __sync_fetch_and_add(&queue[0], 0) < (int)pendingVector.size() ) {
+            workerPid[workerIdx] = SpawnWorker(workerIdx, queue, pendingVector);
+        } else {
+            numAlive--;
+            workerPid[workerIdx] = -1;
+        }
+    }
+    MergeShards(true);
+    munmap(queue, sizeof(int)*(1+numWorker));
+
+    // a worker that died between claiming a design and publishing it left the design without a record
+    for ( auto designIdx : pendingVector ) {
+        if ( !completed[designIdx] ) {
+            printf("[designIdx: %8d] failed (lost by a worker)\n", designIdx);
+            FailDesign(designIdx, "lost");
+        }
+    }
+}
+
+void BatchEngine::FailDesign(int designIdx, const string &reason) {
+    DesignResult result;
+    result.designIdx = designIdx;
+    result.arrayIdx = designSpace->GetArrayIdx(designIdx);
+    result.numHierarchy = designSpace->GetDesignParam(designIdx).size();
+    result.status = DESIGN_FAILED;
+    result.reason = reason;
+    result.area = result.energy = result.latency = result.power = result.topsw = result.tops = 0;
+    result.energyBound = result.latencyBound = result.powerBound = result.topsBound = 0;
+    RecordResult(result);
+    RemoveBreakdown(designIdx);
+    CommitResult(result);
+}
+
+pid_t BatchEngine::SpawnWorker(int workerIdx, int *queue, const vector<int> &pendingVector) {
+    queue[1+workerIdx] = -1;
+    fflush(stdout);
+    fflush(journal);
+    pid_t parentPid = getpid();
+    pid_t pid = fork();
+    if ( pid < 0 ) {
+        cerr << "[Error] worker process cannot be created" << endl;
+        exit(-1);
+    }
+    if ( pid > 0 ) {
+        return pid;
+    }
+
+    /* Worker: records of the completed designs go to its own shard */
+#ifdef __linux__
+    // a worker must not outlive the coordinator (a resumed run would evaluate its designs again)
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if ( getppid() != parentPid ) {
+        _exit(1);
+    }
+#endif
+    worker = true;
+    fclose(journal);
+    string filename = basefolder + "/shards/journal_" + to_string(getpid()) + ".csv";
+    journal = fopen(filename.c_str(), "w");
+    if ( journal == NULL ) {
+        cerr << "[Error] journal shard " << filename << " cannot be opened" << endl;
+        exit(-1);
+    }
+    while ( true ) {
+        int pendingIdx = __sync_fetch_and_add(&queue[0], 1);
+        if ( pendingIdx >= (int)pendingVector.size() ) {
+            break;
+        }
+        int designIdx = pendingVector[pendingIdx];
+        queue[1+workerIdx] = designIdx;
+        if ( resumed ) {
+            RemoveBreakdown(designIdx);
+        }
+        SaveJournal(EvaluateDesign(designIdx));
+        queue[1+workerIdx] = -1;
+    }
+    fclose(journal);
+    fflush(stdout);
+    _exit(0);
+}
+
+void BatchEngine::MergeShards(bool final) {
+    string folder = basefolder + "/shards";
+    DIR *dir = opendir(folder.c_str());
+    if ( dir == NULL ) {
+        return;
+    }
+    vector<string> shardVector;
+    struct dirent *entry;
+    while ( (entry = readdir(dir)) != NULL ) {
+        string name = entry->d_name;
+        if ( name.compare(0, 8, "journal_") == 0 ) {
+            shardVector.push_back(folder + "/" + name);
+        }
+    }
+    closedir(dir);
+    sort(shardVector.begin(), shardVector.end());
+
+    for ( auto &filename : shardVector ) {
+        ifstream fin(filename);
+        fin.seekg(shardOffset[filename]);
+        string line;
+        while ( getline(fin, line) && !fin.eof() ) { // the last line without newline is still being written
+            shardOffset[filename] += line.size() + 1;
+            DesignResult result;
+            if ( !ParseJournal(line, &result) || completed[result.designIdx] ) {
+                continue;
+            }
+            // breakdowns of a design on the front of its worker only
+            if ( !RecordResult(result) && !designSpace->saveAll ) {
+                RemoveBreakdown(result.designIdx);
+            }
+            CommitResult(result);
+        }
+        fin.close();
+        if ( final ) {
+            remove(filename.c_str());
+            shardOffset.erase(filename);
+        }
+    }
+    if ( final ) {
+        rmdir(folder.c_str());
+    }
+}
@@ -0,0 +1,239 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "DesignSpace.h"
+#include "Param.h"
+
+extern Param *param;
+
+DesignSpace::DesignSpace() {
+    // sweep of script_dse.py
+    maxNumHierarchy = 3;
+    for ( int i=1; i < 10; i++ ) { numSubObjectRowList.push_back(i); }
+    for ( int i=1; i < 9; i++ ) { numSubObjectColList.push_back(i); }
+    designParamICBU = {3, 128, 3, 128, 0, 128, 128};      // hBus, SRAM buffer
+    designParamICBUTop = {3, 128, 3, 128, 1, 128, 0};
+    // CIM array of Param.cpp
+    numRowCIMArrayList = {param->numRowCIMArray};
+    numColCIMArrayList = {param->numColCIMArray};
+    levelOutputList = {param->levelOutput};
+    numColMuxedList = {param->numColMuxed};
+    // no constraint
+    maxArea = 0;
+    minTOPS = 0;
+    maxPower = 0;
+    pruneDominated = 0;
+    saveAll = 0;
+    checkpointInterval = 100;
+    numWorker = 0;
+    // exhaustive sweep
+    searchPopulation = 0;
+    searchGeneration = 20;
+    searchSeed = 0;
+    searchSurrogate = 0;
+}
+
+void DesignSpace::ReadConfig(const string &filename) {
+    ifstream infile(filename.c_str());
+    if (!infile.good()) {
+        cerr << "[Error] DSE config [" << filename << "] cannot be opened" << endl;
+        exit(-1);
+    }
+
+    string line, name, val;
+    while (getline(infile, line)) {
+        if ( !line.empty() && (line.back() == '\r') ) { line.pop_back(); }
+        if ( line.empty() || (line[0] == '#') ) { continue; }
+        istringstream iss(line);
+        getline(iss, name, ',');
+        vector<double> realValues;
+        while (getline(iss, val, ',')) {
+            if ( !val.empty() ) { realValues.push_back(atof(val.c_str())); }
+        }
+        vector<int> values(realValues.begin(), realValues.end());
+        if ( values.size() == 0 ) {
+            cerr << "[Error] no value for [" << name << "] in the DSE config" << endl;
+            exit(-1);
+        }
+
+        if ( name == "maxNumHierarchy" ) {
+            maxNumHierarchy = values[0];
+        } else if ( name == "numSubObjectRow" ) {
+            numSubObjectRowList = values;
+        } else if ( name == "numSubObjectCol" ) {
+            numSubObjectColList = values;
+        } else if ( (name == "designParamICBU") && (values.size() == 7) ) {
+            designParamICBU = values;
+        } else if ( (name == "designParamICBUTop") && (values.size() == 7) ) {
+            designParamICBUTop = values;
+        } else if ( name == "numRowCIMArray" ) {
+            numRowCIMArrayList = values;
+        } else if ( name == "numColCIMArray" ) {
+            numColCIMArrayList = values;
+        } else if ( name == "levelOutput" ) {
+            levelOutputList = values;
+        } else if ( name == "numColMuxed" ) {
+            numColMuxedList = values;
+        } else if ( name == "maxArea" ) {
+            maxArea = realValues[0];
+        } else if ( name == "minTOPS" ) {
+            minTOPS = realValues[0];
+        } else if ( name == "maxPower" ) {
+            maxPower = realValues[0];
+        } else if ( name == "pruneDominated" ) {
+            pruneDominated = values[0];
+        } else if ( name == "saveAll" ) {
+            saveAll = values[0];
+        } else if ( name == "checkpointInterval" ) {
+            checkpointInterval = values[0];
+        } else if ( name == "numWorker" ) {
+            numWorker = values[0];
+        } else if ( name == "searchPopulation" ) {
+            searchPopulation = values[0];
+        } else if ( name == "searchGeneration" ) {
+            searchGeneration = values[0];
+        } else if ( name == "searchSeed" ) {
+            searchSeed = values[0];
+        } else if ( name == "searchSurrogate" ) {
+            searchSurrogate = values[0];
+        } else if ( name == "outType" ) {
+            outTypeList = values;
+        } else if ( name == "inType" ) {
+            inTypeList = values;
+        } else if ( name == "busWidth" ) {
+            busWidthList = values;
+        } else if ( name == "buType" ) {
+            buTypeList = values;
+        } else if ( name == "coreBW" ) {
+            coreBWList = values;
+        } else {
+            cerr << "[Error] invalid DSE config: " << line << endl;
+            exit(-1);
+        }
+    }
+    if ( (searchPopulation == 1) || (searchPopulation < 0) || (searchGeneration < 0) ) {
+        cerr << "[Error] searchPopulation should be 0 (exhaustive sweep) or at least 2" << endl;
+        exit(-1);
+    }
+}
+
+void DesignSpace::Enumerate() {
+
+    // CIM array (sweep dimensions of the HierarchyRoot)
+    arrayParamVector.clear();
+    for ( auto numRowCIMArray : numRowCIMArrayList ) {
+        for ( auto numColCIMArray : numColCIMArrayList ) {
+            for ( auto levelOutput : levelOutputList ) {
+                for ( auto numColMuxed : numColMuxedList ) {
+                    arrayParamVector.push_back({numRowCIMArray, numColCIMArray, levelOutput, numColMuxed});
+                }
+            }
+        }
+    }
+
+    // hierarchy (same order as script_dse.py, the top-level numSubObject is tuned by the mapper)
+    hierarchyDesignVector.clear();
+    proposalArrayIdx.clear();
+    proposalDesignParam.clear();
+    if ( searchPopulation > 0 ) { // proposed by the search driver
+        return;
+    }
+    for ( int numHierarchy=1; numHierarchy <= maxNumHierarchy; numHierarchy++ ) {
+        vector<vector<vector<int>>> numHObjVector;
+        for ( int h=0; h < numHierarchy-1; h++ ) {
+            vector<vector<vector<int>>> prevNumHObjVector = numHObjVector;
+            numHObjVector.clear();
+            for ( auto numSubObjectRow : numSubObjectRowList ) {
+                for ( auto numSubObjectCol : numSubObjectColList ) {
+                    if ( (numSubObjectRow == 1) && (numSubObjectCol == 1) ) { continue; }
+                    if ( prevNumHObjVector.size() == 0 ) {
+                        numHObjVector.push_back({{numSubObjectRow, numSubObjectCol}});
+                    } else {
+                        for ( auto numHObj : prevNumHObjVector ) {
+                            numHObj.push_back({numSubObjectRow, numSubObjectCol});
+                            numHObjVector.push_back(numHObj);
+                        }
+                    }
+                }
+            }
+        }
+        if ( numHObjVector.size() == 0 ) {
+            numHObjVector.push_back({{10000, 10000}});
+        } else {
+            for ( auto &numHObj : numHObjVector ) {
+                numHObj.push_back({10000, 10000});
+            }
+        }
+        hierarchyDesignVector.insert(hierarchyDesignVector.end(), numHObjVector.begin(), numHObjVector.end());
+    }
+
+}
+
+int DesignSpace::Size() const {
+    if ( searchPopulation > 0 ) {
+        return searchPopulation * (searchGeneration + 1);
+    }
+    return arrayParamVector.size() * hierarchyDesignVector.size();
+}
+
+int DesignSpace::GetArrayIdx(int designIdx) const {
+    if ( searchPopulation > 0 ) {
+        return proposalArrayIdx[designIdx];
+    }
+    return designIdx / hierarchyDesignVector.size();
+}
+
+vector<vector<int>> DesignSpace::GetDesignParam(int designIdx) const {
+    if ( searchPopulation > 0 ) {
+        return proposalDesignParam[designIdx];
+    }
+    const vector<vector<int>> &numHObj = hierarchyDesignVector[designIdx % hierarchyDesignVector.size()];
+    vector<vector<int>> designParam;
+    for ( int h=0; h < numHObj.size(); h++ ) {
+        vector<int> designParamHObj = numHObj[h];
+        const vector<int> &designParamICBUHObj = ( h == numHObj.size()-1 )? designParamICBUTop : designParamICBU;
+        designParamHObj.insert(designParamHObj.end(), designParamICBUHObj.begin(), designParamICBUHObj.end());
+        designParam.push_back(designParamHObj);
+    }
+    return designParam;
+}
+
+void DesignSpace::ApplyArrayParam(int arrayIdx) const {
+    const vector<int> &arrayParam = arrayParamVector[arrayIdx];
+    param->numRowCIMArray = arrayParam[0];
+    param->numColCIMArray = arrayParam[1];
+    param->levelOutput = arrayParam[2];
+    param->numColMuxed = arrayParam[3];
+}
+
+int DesignSpace::AddDesign(int arrayIdx, const vector<vector<int>> &designParam) {
+    proposalArrayIdx.push_back(arrayIdx);
+    proposalDesignParam.push_back(designParam);
+    return proposalArrayIdx.size() - 1;
+}
+
+static string joinList(const vector<int> &values) {
+    string str;
+    for ( int i=0; i < values.size(); i++ ) {
+        str += ( i == 0 )? to_string(values[i]) : " " + to_string(values[i]);
+    }
+    return str;
+}
+
+string DesignSpace::Describe() const {
+    ostringstream oss;
+    oss << "maxNumHierarchy=" << maxNumHierarchy << ";numSubObjectRow=" << joinList(numSubObjectRowList)
+        << ";numSubObjectCol=" << joinList(numSubObjectColList) << ";designParamICBU=" << joinList(designParamICBU)
+        << ";designParamICBUTop=" << joinList(designParamICBUTop);
+    for ( auto &arrayParam : arrayParamVector ) {
+        oss << ";array=" << joinList(arrayParam);
+    }
+    oss << ";maxArea=" << maxArea << ";minTOPS=" << minTOPS << ";maxPower=" << maxPower << ";pruneDominated=" << pruneDominated;
+    if ( searchPopulation > 0 ) {
+        oss << ";search=" << searchPopulation << "x" << searchGeneration << ";seed=" << searchSeed << ";surrogate=" << searchSurrogate
+            << ";outType=" << joinList(outTypeList) << ";inType=" << joinList(inTypeList) << ";busWidth=" << joinList(busWidthList)
+            << ";buType=" << joinList(buTypeList) << ";coreBW=" << joinList(coreBWList);
+    }
+    return oss.str();
+}
@@ -0,0 +1,180 @@
+#include <cmath>
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include "Evaluator.h"
+#include "Param.h"
+
+extern Param *param;
+
+void Evaluator::Initialize(HierarchyRoot *_hRoot, const vector<HierarchyObject*> &_hObjectVector, double _clkPeriod) {
+    hRoot = _hRoot;
+    hObjectVector = _hObjectVector;
+    clkPeriod = _clkPeriod;
+    networkVector.clear();
+}
+
+void Evaluator::AddNetwork(const string &name, const vector<vector<double>> &networkStructure, double weight) {
+    NetworkEvaluation network;
+    network.name = name;
+    network.weight = weight;
+    network.networkStructure = networkStructure;
+    network.numComputation = 0;
+    for (int i=0; i<networkStructure.size(); i++) {
+        network.numComputation += 2*( networkStructure[i][0] * networkStructure[i][1] * networkStructure[i][2] 
+                                    * networkStructure[i][3] * networkStructure[i][4] * networkStructure[i][5] );
+    }
+    network.networkScheduler.Initialize(networkStructure, hObjectVector.back());
+    networkVector.push_back(network);
+}
+
+void Evaluator::Scheduling(int scheduler_type) {
+
+    // weight replication evaluates the mapping on the shared hierarchy
+    if ( param->replicaBudget > 0 ) {
+        for ( auto &network : networkVector ) {
+            network.networkScheduler.BalanceReplica(scheduler_type, hRoot, hObjectVector);
+        }
+    }
+
+    // the mapping only reads the hierarchy (an exception cannot leave the parallel region, the first one is rethrown)
+    exception_ptr error;
+    #pragma omp parallel for schedule(dynamic)
+    for ( int networkIdx=0; networkIdx < networkVector.size(); networkIdx++ ) {
+        try {
+            networkVector[networkIdx].networkScheduler.Scheduling(scheduler_type);
+        } catch ( ... ) {
+            #pragma omp critical
+            if ( !error ) {
+                error = current_exception();
+            }
+        }
+    }
+    if ( error ) {
+        rethrow_exception(error);
+    }
+
+}
+
+void Evaluator::ReuseSchedule(const Evaluator &base) {
+    if ( base.networkVector.size() != networkVector.size() ) {
+        throw runtime_error("schedule of " + to_string(base.networkVector.size()) + " networks reused for "
+                            + to_string(networkVector.size()) + " networks");
+    }
+    for ( int networkIdx=0; networkIdx < networkVector.size(); networkIdx++ ) {
+        NetworkScheduler &networkScheduler = networkVector[networkIdx].networkScheduler;
+        networkScheduler = base.networkVector[networkIdx].networkScheduler;
+        networkScheduler.hTop = hObjectVector.back();
+    }
+}
+
+void Evaluator::CalculatePerformance() {
+
+    // normalize the weights of the networks
+    double totalWeight = 0;
+    for ( auto &network : networkVector ) {
+        totalWeight += network.weight;
+    }
+    for ( auto &network : networkVector ) {
+        network.weight /= totalWeight;
+    }
+
+    numComputation = 0;
+    dynamicEnergy = 0;
+    leakageEnergy = 0;
+    imageLatency = 0;
+    latency = 0;
+    chipLatencyVector.clear();
+    chipEnergyVector.clear();
+    networkLatencyVector2.clear();
+    networkEnergyVector2.clear();
+
+    for ( auto &network : networkVector ) {
+        NetworkScheduler &networkScheduler = network.networkScheduler;
+
+        networkScheduler.CalculatePerformance(&network.networkLatencyVector, &network.networkEnergyVector, 
+                                               &network.layerLatencyVector2, &network.layerEnergyVector2,
+                                               &network.networkLatencyVector2, &network.networkEnergyVector2, 
+                                               hRoot, hObjectVector, networkScheduler.networkInfoRead);
+
+        /* Pipelined execution (latency per image in steady state = pipeline interval, stages of the batch) */
+        if ( param->pipeline || (param->batchSize > 1) ) {
+            networkScheduler.CalculatePipeline(&network.layerLatencyVector2);
+        }
+
+        /* Power gating of the units idle in each layer (average leakage power) */
+        network.chipLeakage = hObjectVector.back()->leakage;
+        if ( param->powerGating ) {
+            network.chipLeakage = networkScheduler.CalculatePowerGating(network.chipLeakage, hRoot, hObjectVector, 
+                                                                        networkScheduler.networkInfoRead,
+                                                                        &network.networkLatencyVector);
+        }
+
+        /* Mergy latency / energy info */
+        network.chipLatencyVector.clear();
+        network.chipEnergyVector.clear();
+        for (int layerIdx=0; layerIdx < network.networkLatencyVector.size(); layerIdx++) {
+            vector<double> &latencyVector = network.networkLatencyVector[layerIdx];
+            vector<double> &readDynamicEnergyVector = network.networkEnergyVector[layerIdx];
+            if ( network.chipLatencyVector.size() == 0 ) {
+                network.chipLatencyVector.assign(latencyVector.begin(), latencyVector.end());
+                network.chipEnergyVector.assign(readDynamicEnergyVector.begin(), readDynamicEnergyVector.end());
+            } else {
+                for (int latencyIdx=0; latencyIdx < latencyVector.size(); latencyIdx++) {
+                    network.chipLatencyVector[latencyIdx] += latencyVector[latencyIdx];
+                }
+                for (int energyIdx=0; energyIdx < readDynamicEnergyVector.size(); energyIdx++) {
+                    network.chipEnergyVector[energyIdx] += readDynamicEnergyVector[energyIdx];
+                }
+            }
+        }
+
+        /* Batched execution */
+        networkScheduler.CalculateBatch(param->batchSize, network.chipLatencyVector[0]);
+
+        // latency per image (pipeline interval in steady state, average over the batch for batched execution)
+        network.imageLatency = param->pipeline? networkScheduler.pipelineInterval: network.chipLatencyVector[0];
+        if ( param->batchSize > 1 ) {
+            network.imageLatency = networkScheduler.batchLatency / param->batchSize;
+        }
+        network.latency = param->pipeline? networkScheduler.pipelineLatency: network.chipLatencyVector[0];
+        network.chipLeakageEnergy = network.chipLeakage * network.imageLatency * clkPeriod;
+        network.topsw = network.numComputation/(network.chipEnergyVector[0]+network.chipLeakageEnergy)/1e12;
+        network.tops = network.numComputation/(network.imageLatency*clkPeriod)/1e12;
+
+        /* Weighted aggregate (a weighted mix of images of the networks) */
+        double weight = network.weight;
+        numComputation += weight * network.numComputation;
+        dynamicEnergy += weight * network.chipEnergyVector[0];
+        leakageEnergy += weight * network.chipLeakageEnergy;
+        imageLatency += weight * network.imageLatency;
+        latency += weight * network.latency;
+        chipLatencyVector.resize(network.chipLatencyVector.size(), 0);
+        chipEnergyVector.resize(network.chipEnergyVector.size(), 0);
+        for (int i=0; i < chipLatencyVector.size(); i++) {
+            chipLatencyVector[i] += weight * network.chipLatencyVector[i];
+        }
+        for (int i=0; i < chipEnergyVector.size(); i++) {
+            chipEnergyVector[i] += weight * network.chipEnergyVector[i];
+        }
+        networkLatencyVector2.resize(network.networkLatencyVector2.size());
+        networkEnergyVector2.resize(network.networkEnergyVector2.size());
+        for (int h=0; h < networkLatencyVector2.size(); h++) {
+            networkLatencyVector2[h].resize(network.networkLatencyVector2[h].size(), 0);
+            for (int i=0; i < networkLatencyVector2[h].size(); i++) {
+                networkLatencyVector2[h][i] += weight * network.networkLatencyVector2[h][i];
+            }
+        }
+        for (int h=0; h < networkEnergyVector2.size(); h++) {
+            networkEnergyVector2[h].resize(network.networkEnergyVector2[h].size(), 0);
+            for (int i=0; i < networkEnergyVector2[h].size(); i++) {
+                networkEnergyVector2[h][i] += weight * network.networkEnergyVector2[h][i];
+            }
+        }
+    }
+
+    topsw = numComputation/(dynamicEnergy+leakageEnergy)/1e12;
+    tops = numComputation/(imageLatency*clkPeriod)/1e12;
+
+}
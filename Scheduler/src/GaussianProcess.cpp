@@ -0,0 +1,119 @@
+#include <cmath>
+#include "GaussianProcess.h"
+
+GaussianProcess::GaussianProcess(double _lengthScale, double _noise):
+                                 lengthScale(_lengthScale), noise(_noise) {
+}
+
+double GaussianProcess::Kernel(const vector<double> &a, const vector<double> &b) const {
+    double distance = 0;
+    for ( int i=0; i < a.size(); i++ ) {
+        distance += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return exp(-0.5 * distance / (lengthScale * lengthScale));
+}
+
+/* forward substitution with the lower triangular factor (L x = b) */
+static vector<double> solveLower(const vector<vector<double>> &L, const vector<double> &b) {
+    vector<double> x(b.size());
+    for ( int i=0; i < b.size(); i++ ) {
+        double sum = b[i];
+        for ( int j=0; j < i; j++ ) {
+            sum -= L[i][j] * x[j];
+        }
+        x[i] = sum / L[i][i];
+    }
+    return x;
+}
+
+/* backward substitution with the transpose of the factor (L^T x = b) */
+static vector<double> solveUpper(const vector<vector<double>> &L, const vector<double> &b) {
+    vector<double> x(b.size());
+    for ( int i=b.size()-1; i >= 0; i-- ) {
+        double sum = b[i];
+        for ( int j=i+1; j < b.size(); j++ ) {
+            sum -= L[j][i] * x[j];
+        }
+        x[i] = sum / L[i][i];
+    }
+    return x;
+}
+
+void GaussianProcess::Fit(const vector<vector<double>> &_inputVector, const vector<vector<double>> &targetVector) {
+    inputVector = _inputVector;
+    int numInput = inputVector.size();
+    int numOutput = targetVector.empty()? 0 : targetVector[0].size();
+
+    // standardized outputs
+    targetMean.assign(numOutput, 0);
+    targetStd.assign(numOutput, 0);
+    for ( int k=0; k < numOutput; k++ ) {
+        for ( int i=0; i < numInput; i++ ) {
+            targetMean[k] += targetVector[i][k] / numInput;
+        }
+        for ( int i=0; i < numInput; i++ ) {
+            targetStd[k] += (targetVector[i][k] - targetMean[k]) * (targetVector[i][k] - targetMean[k]) / numInput;
+        }
+        targetStd[k] = ( targetStd[k] > 0 )? sqrt(targetStd[k]) : 1;
+    }
+
+    // Cholesky factor of K + noise*I (jitter is raised until the matrix is positive definite)
+    double jitter = noise;
+    bool positiveDefinite = false;
+    while ( !positiveDefinite ) {
+        positiveDefinite = true;
+        choleskyL.assign(numInput, vector<double>(numInput, 0));
+        for ( int i=0; (i < numInput) && positiveDefinite; i++ ) {
+            for ( int j=0; j <= i; j++ ) {
+                double sum = Kernel(inputVector[i], inputVector[j]) + (( i == j )? jitter : 0);
+                for ( int l=0; l < j; l++ ) {
+                    sum -= choleskyL[i][l] * choleskyL[j][l];
+                }
+                if ( i == j ) {
+                    if ( sum <= 0 ) {
+                        positiveDefinite = false;
+                        break;
+                    }
+                    choleskyL[i][i] = sqrt(sum);
+                } else {
+                    choleskyL[i][j] = sum / choleskyL[j][j];
+                }
+            }
+        }
+        jitter *= 10;
+    }
+
+    alphaVector.clear();
+    for ( int k=0; k < numOutput; k++ ) {
+        vector<double> y(numInput);
+        for ( int i=0; i < numInput; i++ ) {
+            y[i] = (targetVector[i][k] - targetMean[k]) / targetStd[k];
+        }
+        alphaVector.push_back(solveUpper(choleskyL, solveLower(choleskyL, y)));
+    }
+}
+
+void GaussianProcess::Predict(const vector<double> &input, vector<double> *mean, vector<double> *std) const {
+    vector<double> kernelVector(inputVector.size());
+    for ( int i=0; i < inputVector.size(); i++ ) {
+        kernelVector[i] = Kernel(input, inputVector[i]);
+    }
+    // variance of the standardized outputs (shared by the outputs)
+    vector<double> v = solveLower(choleskyL, kernelVector);
+    double variance = 1;
+    for ( auto value : v ) {
+        variance -= value * value;
+    }
+    variance = ( variance > 0 )? variance : 0;
+
+    mean->clear();
+    std->clear();
+    for ( int k=0; k < alphaVector.size(); k++ ) {
+        double mu = 0;
+        for ( int i=0; i < inputVector.size(); i++ ) {
+            mu += kernelVector[i] * alphaVector[k][i];
+        }
+        mean->push_back(targetMean[k] + mu * targetStd[k]);
+        std->push_back(sqrt(variance) * targetStd[k]);
+    }
+}
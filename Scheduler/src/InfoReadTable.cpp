@@ -0,0 +1,111 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include "InfoReadTable.h"
+#include "Param.h"
+
+extern Param *param;
+
+void InfoReadTable::Clear() {
+    header.clear();
+    root.clear();
+    object.clear();
+    ic.clear();
+}
+
+/* Push records (payload fields are narrowed by the scheduler with InfoReadField) */
+void InfoReadTable::PushRoot(int layerIdx, double idxRow, double idxCol, const InfoReadRoot &_root) {
+    InfoRead infoRead;
+    infoRead.layerIdx = InfoReadField<uint16_t>(layerIdx, "layerIdx");
+    infoRead.hlevel = 0;
+    infoRead.type = INFOREAD_ROOT;
+    infoRead.idxRow = InfoReadField<uint16_t>(idxRow, "idxRow");
+    infoRead.idxCol = InfoReadField<uint16_t>(idxCol, "idxCol");
+    infoRead.idxData = root.size();
+    header.push_back(infoRead);
+    root.push_back(_root);
+}
+
+void InfoReadTable::PushObject(int layerIdx, int hlevel, double idxRow, double idxCol, const InfoReadObject &_object) {
+    InfoRead infoRead;
+    infoRead.layerIdx = InfoReadField<uint16_t>(layerIdx, "layerIdx");
+    infoRead.hlevel = InfoReadField<uint8_t>(hlevel, "hlevel");
+    infoRead.type = INFOREAD_OBJECT;
+    infoRead.idxRow = InfoReadField<uint16_t>(idxRow, "idxRow");
+    infoRead.idxCol = InfoReadField<uint16_t>(idxCol, "idxCol");
+    infoRead.idxData = object.size();
+    header.push_back(infoRead);
+    object.push_back(_object);
+}
+
+void InfoReadTable::PushIC(int layerIdx, int hlevel, double idxRow, double idxCol, const InfoReadIC &_ic) {
+    InfoRead infoRead;
+    infoRead.layerIdx = InfoReadField<uint16_t>(layerIdx, "layerIdx");
+    infoRead.hlevel = InfoReadField<uint8_t>(hlevel, "hlevel");
+    infoRead.type = INFOREAD_IC;
+    infoRead.idxRow = InfoReadField<uint16_t>(idxRow, "idxRow");
+    infoRead.idxCol = InfoReadField<uint16_t>(idxCol, "idxCol");
+    infoRead.idxData = ic.size();
+    header.push_back(infoRead);
+    ic.push_back(_ic);
+}
+
+/* infoRead for HierarchyRoot::CalculateLatency/CalculatePower */
+vector<double> InfoReadTable::GetInfoReadHRoot(int infoIdx) const {
+    const InfoReadRoot &r = root[header[infoIdx].idxData];
+    return {(double)r.weightMatrixRow, (double)r.weightMatrixCol,
+            (double)r.numBitInput, (double)r.numCellPerSynapse, r.numRead,
+            (double)header[infoIdx].layerIdx}; // layerIdx for the input activity profile
+}
+
+/* infoRead for HierarchyObject::CalculateLatency/CalculatePower (DE, IC, BU) */
+vector<double> InfoReadTable::GetInfoReadHObject(int infoIdx) const {
+    const InfoReadObject &o = object[header[infoIdx].idxData];
+    return {o.numReadAdderTree, (double)o.numUnitAdd, o.numReadReLu, o.numReadMaxPool,
+            0, 0, 0, 0, 0, 0, // IC is scheduled with separate IC records
+            o.infoReadBU[0], o.infoReadBU[1], o.infoReadBU[2],
+            o.infoReadBU[3], o.infoReadBU[4], o.infoReadBU[5]};
+}
+
+/* infoRead for HierarchyObject::CalculateICLatency/CalculateICPower */
+vector<double> InfoReadTable::GetInfoReadIC(int infoIdx) const {
+    const InfoReadIC &c = ic[header[infoIdx].idxData];
+    return {(double)c.state, (double)c.dataType, c.numRead,
+            (double)c.numHopsRow, (double)c.numHopsCol, 0/*dummy*/};
+}
+
+/* full record (layerIdx, hlevel, idxRow, idxCol, payload) */
+vector<double> InfoReadTable::GetInfoRead(int infoIdx) const {
+    const InfoRead &h = header[infoIdx];
+    vector<double> infoRead = {(double)h.layerIdx, (double)h.hlevel, (double)h.idxRow, (double)h.idxCol};
+    vector<double> payload;
+
+    if ( h.type == INFOREAD_ROOT ) {
+        payload = GetInfoReadHRoot(infoIdx);
+    } else if ( h.type == INFOREAD_IC ) {
+        payload = GetInfoReadIC(infoIdx);
+    } else {
+        const InfoReadObject &o = object[h.idxData];
+        payload = {(double)o.weightMatrixRow, (double)o.weightMatrixCol, 0, 0, 0};
+        vector<double> infoReadHObject = GetInfoReadHObject(infoIdx);
+        payload.insert(payload.end(), infoReadHObject.begin(), infoReadHObject.end());
+    }
+    infoRead.insert(infoRead.end(), payload.begin(), payload.end());
+
+    // zero padding for root record
+    int length = ( h.type == INFOREAD_IC )? param->lengthInfoReadForIC: param->lengthInfoRead;
+    infoRead.resize(length, 0);
+
+    return infoRead;
+}
+
+/* write scheduling results to the csv file */
+void InfoReadTable::SaveCSV(const string &filename) const {
+    ofstream out(filename);
+    for (int infoIdx=0; infoIdx < Size(); infoIdx++) {
+        for (auto col : GetInfoRead(infoIdx)) {
+            out << col << ',';
+        }
+        out << '\n';
+    }
+}
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <iostream>
 #include <stdlib.h>
+#include "DesignError.h"
 #include "LayerScheduler.h"
 #include "Param.h"
 
@@ -11,12 +12,11 @@ LayerScheduler::LayerScheduler() {
     numBitInput = param->numBitInput;
     numCellPerSynapse = param->numColPerSynapse;
     numColMuxed = param->numColMuxed;
-    lengthInfoRead = param->lengthInfoRead;
 }
 
 void LayerScheduler::Initialize(int _layerIdx, vector<double> _layerStructure,
                                 int _hlevelMappingUnit, vector<vector<int>> _idxOffsetVector,
-                                const HierarchyObject* hTop){
+                                const HierarchyObject* hTop, int _numReplica){
    
     layerIdx = _layerIdx;
     layerStructure = _layerStructure;
@@ -38,6 +38,15 @@ void LayerScheduler::Initialize(int _layerIdx, vector<double> _layerStructure,
     outH = ceil( ( inH + 2*layerStructure[7] - kH ) / layerStructure[8] ) + 1;
     numConv = outW * outH;
 
+    // per-layer precision (9-wbits, 10-abits), global precision when not given
+    if ( layerStructure.size() > 10 ) {
+        numCellPerSynapse = (int)ceil(layerStructure[9] / param->cellBit);
+        numBitInput = (int)layerStructure[10];
+    } else {
+        numCellPerSynapse = param->numColPerSynapse;
+        numBitInput = param->numBitInput;
+    }
+
     // initialize parameters
     doingAct = false;
     doingMaxPool = false;
@@ -51,6 +60,12 @@ void LayerScheduler::Initialize(int _layerIdx, vector<double> _layerStructure,
     // check Linear Array
     CheckLinearArray(hTop);
 
+    // each replica computes a part of the output rows on its own top-level subObjects
+    replicable = !hTop->inputBuffer
+                 && (hlevelRowSystolic < hlevelTop - 1 || (hlevelRowSystolic == hlevelTop - 1 && numHObjectRowSAExt <= 1))
+                 && (hlevelColSystolic < hlevelTop - 1 || (hlevelColSystolic == hlevelTop - 1 && numHObjectColSAExt <= 1));
+    numReplica = replicable? MIN(_numReplica, (int)outH) : 1;
+
 }
 
 /* Recursively check if any HiearchyObject has Linear Array & get hlevel of HierarchyObject with Systolic array */
@@ -71,44 +86,36 @@ void LayerScheduler::CheckLinearArray(const HierarchyObject* hObject) {
 }
 
 /* HierarchyRoot Scheduling */
-vector<double> LayerScheduler::HRootScheduling(const HierarchyRoot* hRoot, 
+void LayerScheduler::HRootScheduling(const HierarchyRoot* hRoot, 
                     double idxRow, double idxCol, 
-                    double weightMatrixRow, double weightMatrixCol) {
+                    double weightMatrixRow, double weightMatrixCol,
+                    InfoReadTable *infoReadTable) {
 
     // Check if we received weight matrix with proper size
     if ( hRoot->numRow < weightMatrixRow ) {
-        cerr << "[Error] weightMatrixRow is larger than hRoot numRow" << endl;
-        exit(-1);
+        throw DesignError("arrayRow", "weightMatrixRow is larger than hRoot numRow");
     } else if ( hRoot->numCol < weightMatrixCol ) {
-        cerr << "[Error] weightMatrixCol is larger than hRoot numCol" << endl;
-        exit(-1);
+        throw DesignError("arrayCol", "weightMatrixCol is larger than hRoot numCol");
     }
 
-    // clear vector
-    vector<double> infoRead;
-    infoRead.assign(lengthInfoRead, 0);
-
     // generate inforRead
-    infoRead[0] = (double)layerIdx;
-    infoRead[1] = 0; // hlevel
-    infoRead[2] = idxRow;
-    infoRead[3] = idxCol;
-    infoRead[4] = weightMatrixRow;
-    infoRead[5] = weightMatrixCol;
-    infoRead[6] = numBitInput;
-    infoRead[7] = numCellPerSynapse;
-    infoRead[8] = numConv; // numReadArray
-
-    return infoRead;
+    InfoReadRoot infoRead;
+    infoRead.weightMatrixRow = InfoReadField<uint16_t>(weightMatrixRow, "weightMatrixRow");
+    infoRead.weightMatrixCol = InfoReadField<uint16_t>(weightMatrixCol, "weightMatrixCol");
+    infoRead.numBitInput = InfoReadField<uint8_t>(numBitInput, "numBitInput");
+    infoRead.numCellPerSynapse = InfoReadField<uint8_t>(numCellPerSynapse, "numCellPerSynapse");
+    infoRead.numRead = numConv; // numReadArray
+
+    infoReadTable->PushRoot(layerIdx, idxRow, idxCol, infoRead);
 
 }
 
 /* HierarchyObject Scheduling 
 * Scheduler type00 - base (tile-wise mapping) */
-vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObject *hObject,
+void LayerScheduler::HObjectScheduling_00(const HierarchyObject *hObject,
                                 double idxRow, double idxCol, 
                                 double wRow, double wCol, double wInC, double wOutC,
-                                bool offsetObject, bool lastObject) {
+                                bool offsetObject, bool lastObject, InfoReadTable *infoReadTable) {
 
     // Check if the kernel is split in spatial dim or Channel dim
     // Row-dim
@@ -161,14 +168,11 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     int idxType = ( hObject->inputBuffer || spatialColMapping || spatialRowMapping )? 0: 1;
 
     // check if IC info
-    const InterConnect *IC = hObject->interConnect;
+    const InterConnect *IC = hObject->interConnect.get();
     int icOutType = IC->outType;
     int icInType = IC->inType;
     BusMode icInBusMode = IC->inBusMode;
 
-    // generate vector
-    vector<vector<double>> infoReadVector;
-
     //*** [STEP1] Scheduling Sub-HierarchyObject ***//
 
     // Calculate the number of used subObject // NOTE: modify for intra-layer SubObject splitting
@@ -194,8 +198,8 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     bool lastSubObject = false;
     double wRowSubObject, wColSubObject, wInCSubObject, wOutCSubObject;
     // for mesh scheduling
-    vector<double> infoReadICIn, infoReadICOut;
-    vector<vector<double>> infoReadICInVector, infoReadICOutVector;
+    InfoReadIC infoReadICIn, infoReadICOut;
+    vector<InfoReadIC> infoReadICInVector, infoReadICOutVector;
     double numOutBitSubObject, numInBitSubObject;
     int prevIdxSubObjectRow;
     double icState = 1; /*reset before update*/
@@ -238,36 +242,29 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
                  (idxSubObjectCol < 0) || (idxSubObjectCol >= hObject->numSubObjectCol) ) {
                 //cout << hlevelTop << " " << hObject->hlevel << " " << idxSubObjectRow << " " << idxSubObjectCol << endl;
                 //cout << hObject->numSubObjectRow << " " << hObject->numSubObjectCol << endl;
-                cerr << "[Error] Invalid idxSubObjectRow/Col!" << endl;
-                exit(-1);
+                throw DesignError("subObjectIndex", "Invalid idxSubObjectRow/Col!");
             }
         
             // scheduling sub-object 
             if ( hObject->hlevel == 1 ) {
                 if ( (wRowSubObject > 1) || (wColSubObject > 1) ) {
-                    cerr << "[Error] wRow/Col for hRootObject should be 1!" << endl;
-                    exit(-1);
+                    throw DesignError("rootMapping", "wRow/Col for hRootObject should be 1!");
                 }
-                vector<double> infoReadSub = HRootScheduling( hObject->rootObject, idxSubObjectRow, idxSubObjectCol, 
-                                                            wInCSubObject, wOutCSubObject);
-                infoReadVector.push_back(infoReadSub); // update scheduling result
-                infoReadSub.clear(); // clear updated result
+                HRootScheduling( hObject->rootObject, idxSubObjectRow, idxSubObjectCol, 
+                                wInCSubObject, wOutCSubObject, infoReadTable); // update scheduling result
             } else {
-                vector<vector<double>> infoReadVectorSub 
-                                            = HObjectScheduling_00( hObject->subObject, idxSubObjectRow, idxSubObjectCol, 
-                                                            wRowSubObject, wColSubObject, wInCSubObject, wOutCSubObject,
-                                                            offsetSubObject, lastSubObject);
-                infoReadVector.insert(infoReadVector.end(), infoReadVectorSub.begin(), infoReadVectorSub.end()); // update
-                infoReadVectorSub.clear(); // clear updated result
+                HObjectScheduling_00( hObject->subObject, idxSubObjectRow, idxSubObjectCol, 
+                                    wRowSubObject, wColSubObject, wInCSubObject, wOutCSubObject,
+                                    offsetSubObject, lastSubObject, infoReadTable); // update scheduling result
             }
 
             // update infoReadIC
-            // (layerIdx, hlevel, idxRow, idxCol, state, dataType, numRead, numHopsRow, numHopsCol, dummy)
+            // (numRead, numHopsRow, numHopsCol, state, dataType)
             if ((icOutType == 2 /*2D Mesh*/) || (icOutType == 3 /*HBus*/)) {
                 //printf("wOutC: %10d, wOutCSubObject: %10d\n", (int)wOutC, (int)wOutCSubObject);
                 numOutBitSubObject = numConv * wOutCSubObject / numCellPerSynapse * hObject->numOutBitSubObject;
-                infoReadICOut = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, icState, 0/*dataType*/,
-                                numOutBitSubObject / IC->outBusWidth, (double)idxSubObjectRow, 0, 0}; // no col dim move of out
+                infoReadICOut = {numOutBitSubObject / IC->outBusWidth, InfoReadField<int16_t>(idxSubObjectRow, "numHopsRow"), 0, // no col dim move of out
+                                InfoReadField<uint8_t>(icState, "icState"), 0/*dataType*/};
                 infoReadICOutVector.push_back(infoReadICOut);
                 icState = 2; /*cumulate*/
             }
@@ -283,26 +280,25 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
                     } else {
                         numInBitSubObject = numConv * ( wRowSubObject * wColSubObject * wInCSubObject) * numBitInput;
                     }
-                    infoReadICIn = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2/*icState*/, 1/*dataType*/,
-                                numInBitSubObject / IC->inBusWidth, (double)idxSubObjectRow, (double)idxSubObjectCol};
+                    infoReadICIn = {numInBitSubObject / IC->inBusWidth, InfoReadField<int16_t>(idxSubObjectRow, "numHopsRow"),
+                                InfoReadField<int16_t>(idxSubObjectCol, "numHopsCol"), 2/*icState*/, 1/*dataType*/};
                 } else { // input sharing
                     if ( prevIdxSubObjectRow == idxSubObjectRow ) {
-                        infoReadICIn.back() = MAX(infoReadICIn.back(), idxSubObjectCol); // horizontal & same row -> update the col idx
+                        infoReadICIn.numHopsCol = MAX(infoReadICIn.numHopsCol, idxSubObjectCol); // horizontal & same row -> update the col idx
                     } else { // rowIdx of input changed -> update prev input info & get new row input feeding info
                         if ( (icInType == 3 /*HBus*/) && (prevIdxSubObjectRow % 2 == 0)  ) { // row bus sharing for HBus
-                            infoReadICIn.rbegin()[1] = (double)idxSubObjectRow;
-                            infoReadICIn.back() = MAX(infoReadICIn.back(), idxSubObjectCol);
+                            infoReadICIn.numHopsRow = InfoReadField<int16_t>(idxSubObjectRow, "numHopsRow");
+                            infoReadICIn.numHopsCol = MAX(infoReadICIn.numHopsCol, idxSubObjectCol);
                         }
                         else {
-                            infoReadICIn.push_back(0/*dummy*/);
-                            infoReadICInVector.push_back(infoReadICIn); // NOTE: BUG: Latency should be overlapped
-                            double rowMove = (double)(idxSubObjectRow - prevIdxSubObjectRow);
+                            infoReadICInVector.push_back(infoReadICIn); // (overlapped with the computation when inputOverlap=1)
+                            int rowMove = idxSubObjectRow - prevIdxSubObjectRow;
                             if ( icInType == 2 /*2D Mesh*/ ) {
-                                infoReadICIn = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2, 1/*dataType*/,
-                                        numInBitSubObject / IC->inBusWidth, rowMove, (double)idxSubObjectCol};
+                                infoReadICIn = {numInBitSubObject / IC->inBusWidth, InfoReadField<int16_t>(rowMove, "numHopsRow"),
+                                        InfoReadField<int16_t>(idxSubObjectCol, "numHopsCol"), 2, 1/*dataType*/};
                             } else {
-                                infoReadICIn = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2, 1/*dataType*/,
-                                        numInBitSubObject / IC->inBusWidth, rowMove + 1, (double)idxSubObjectCol};
+                                infoReadICIn = {numInBitSubObject / IC->inBusWidth, InfoReadField<int16_t>(rowMove + 1, "numHopsRow"),
+                                        InfoReadField<int16_t>(idxSubObjectCol, "numHopsCol"), 2, 1/*dataType*/};
                             }
                         }
                     }
@@ -317,7 +313,6 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
 
         // update infoReadICIn
         if ((icInType == 2 /*2D Mesh*/) || (icInType == 3 /*HBus*/)) {
-            infoReadICIn.push_back(0/*dummy*/);
             infoReadICInVector.push_back(infoReadICIn);
         }
 
@@ -331,17 +326,15 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     // check if there was any overflow in the subObject index
     if ( idxType == 0 ) {
         if ( ( (idxSubObjectRow + 1) > hObject->numSubObjectRow ) || ( (idxSubObjectCol + 1) > hObject->numSubObjectCol) ) {
-            cerr << "[ERROR] index of subObject row overflow" << endl;
-            cerr << "last idxSubObjectRow: " << idxSubObjectRow <<  ", subObjectRow: " << hObject->numSubObjectRow << endl;
-            cerr << "last idxSubObjectCol: " << idxSubObjectCol <<  ", subObjectCol: " << hObject->numSubObjectCol << endl;
-            exit(-1);
+            throw DesignError("subObjectOverflow", "index of subObject overflow (last idxSubObjectRow: " + to_string(idxSubObjectRow)
+                                + ", subObjectRow: " + to_string(hObject->numSubObjectRow) + ", last idxSubObjectCol: " + to_string(idxSubObjectCol)
+                                + ", subObjectCol: " + to_string(hObject->numSubObjectCol) + ")");
         }
     } else { // idxType == 1
         int numUsedSub = subObjectCounter + idxOffsetRow;
         if ( numUsedSub > hObject->numSubObject ) {
-            cerr << "[ERROR] number of subObject overflow" << endl;
-            cerr << "used numSubObject: " << numUsedSub << ", available numSubObject: " << hObject->numSubObject << endl;
-            exit(-1);
+            throw DesignError("subObjectOverflow", "number of subObject overflow (used numSubObject: " + to_string(numUsedSub)
+                                + ", available numSubObject: " + to_string(hObject->numSubObject) + ")");
         }
     }
 
@@ -371,23 +364,14 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     }
 
     //*** [STEP1] Scheduling Current HierarchyObject ***//
-    vector<double> infoRead; // storage for update scheduling results
+    InfoReadObject infoRead; // storage for update scheduling results
     
     // update object info
-    infoRead.push_back((double)layerIdx);
-    infoRead.push_back((double)hObject->hlevel); // hlevel
-    infoRead.push_back(idxRow); // object row index
-    infoRead.push_back(idxCol); // object col index
-    infoRead.push_back(wRow * wCol * wInC); 
-    infoRead.push_back(wOutC); 
-
-    // update infoReadCIM
-    infoRead.push_back(0);  // numBitInput
-    infoRead.push_back(0);  // numCellPerSynapse
-    infoRead.push_back(0);  // numRead Array
+    infoRead.weightMatrixRow = InfoReadField<uint32_t>(wRow * wCol * wInC, "weightMatrixRow");
+    infoRead.weightMatrixCol = InfoReadField<uint32_t>(wOutC, "weightMatrixCol");
 
     //*** [STEP2] Scheduling DE ***//
-    const DigitalElements *DE = hObject->digitalElements;
+    const DigitalElements *DE = hObject->digitalElements.get();
     double numRead, numUnitAdd;
 
     // number of total output 
@@ -401,8 +385,8 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
         numRead = 0;
         numUnitAdd = 0;
     }
-    infoRead.push_back(numRead);
-    infoRead.push_back(numUnitAdd);
+    infoRead.numReadAdderTree = numRead;
+    infoRead.numUnitAdd = InfoReadField<uint32_t>(numUnitAdd, "numUnitAdd");
 
     // reLu
     if ( DE->placeReLu && (wRow * wCol * wInC == fanIn) && !doneAct) { // has reLu unit & finished MAC operation
@@ -411,7 +395,7 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     } else {
         numRead = 0;
     }
-    infoRead.push_back(numRead);
+    infoRead.numReadReLu = numRead;
 
     // maxPool
     if ( DE->placeMaxPooling && (doingAct || doneAct) && !doneMaxPool) { // has maxPooling unit & finished MAC operation
@@ -420,7 +404,7 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     } else {
         numRead = 0;
     }
-    infoRead.push_back(numRead);
+    infoRead.numReadMaxPool = numRead;
     
 
     //*** [STEP3] Scheduling IC ***//
@@ -444,28 +428,30 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
     
     // update infoReadICVector for output
     if ((icOutType == 2 /*2D Mesh*/) || (icOutType == 3 /*HBus*/)) {
-        infoReadVector.insert(infoReadVector.end(), infoReadICOutVector.begin(), infoReadICOutVector.end());
+        for (auto& infoReadIC : infoReadICOutVector) {
+            infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, infoReadIC);
+        }
         infoReadICOutVector.clear();
     } else {
         // numOutRead
         double numOutRead = totalOutBit / IC->outBusWidth;
         
         // update IC infoRead // NOTE:BUG: assume single layer on hObject w/ Linear Array
-        vector<double> tmpInfoReadIC; 
+        InfoReadIC tmpInfoReadIC; 
         if ( IC->outType == 1 /*LinearArray*/) {
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 1/*icState*/, 0/*dataType*/,
-                            numOutRead, (double)numSubObjectRow, (double)numSubObjectCol, 0/*dummy*/};
+            tmpInfoReadIC = {numOutRead, InfoReadField<int16_t>(numSubObjectRow, "numSubObjectRow"),
+                            InfoReadField<int16_t>(numSubObjectCol, "numSubObjectCol"), 1/*icState*/, 0/*dataType*/};
         } else{
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 1/*icState*/, 0/*dataType*/,
-                            numOutRead, 0, 0, 0/*dummy*/};
+            tmpInfoReadIC = {numOutRead, 0, 0, 1/*icState*/, 0/*dataType*/};
         }
-        infoReadVector.push_back(tmpInfoReadIC);
-        tmpInfoReadIC.clear();
+        infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, tmpInfoReadIC);
     }
 
     // update infoReadICVector for input
     if ((icInType == 2 /*2D Mesh*/) || (icInType == 3 /*HBus*/)) {
-        infoReadVector.insert(infoReadVector.end(), infoReadICInVector.begin(), infoReadICInVector.end());
+        for (auto& infoReadIC : infoReadICInVector) {
+            infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, infoReadIC);
+        }
         infoReadICInVector.clear();
     } else {
         double numInRead;
@@ -478,26 +464,19 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
         }
 
         // update IC infoRead // NOTE:BUG: assume single layer on hObject w/ Linear Array
-        vector<double> tmpInfoReadIC; 
+        InfoReadIC tmpInfoReadIC; 
         if ( IC->inType == 1 /*LinearArray*/) {
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2/*icState*/, 1/*dataType*/,
-                            numInRead, (double)numSubObjectRow, (double)numSubObjectCol, 0/*dummy*/};
+            tmpInfoReadIC = {numInRead, InfoReadField<int16_t>(numSubObjectRow, "numSubObjectRow"),
+                            InfoReadField<int16_t>(numSubObjectCol, "numSubObjectCol"), 2/*icState*/, 1/*dataType*/};
         } else{
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2/*icState*/, 1/*dataType*/,
-                            numInRead, 0, 0, 0/*dummy*/};
+            tmpInfoReadIC = {numInRead, 0, 0, 2/*icState*/, 1/*dataType*/};
         }
-        infoReadVector.push_back(tmpInfoReadIC);
-        tmpInfoReadIC.clear();
+        infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, tmpInfoReadIC);
     }
 
-    // empty IC infoRead
-    vector<double> tmpInfoReadIC = {0, 0, 0, 0, 0, 0};
-    infoRead.insert(infoRead.end(), tmpInfoReadIC.begin(), tmpInfoReadIC.end());
-    tmpInfoReadIC.clear();
-
 
     //*** [STEP4] Scheduling BU ***//
-    const BufferUnit *BU = hObject->bufferUnit;
+    const BufferUnit *BU = hObject->bufferUnit.get();
     double numOutRead, numOutWrite, numInRead, numInWrite, outParallelism, inParallelism;
 
     // get output data size stored in buffer unit (BU)
@@ -546,15 +525,13 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_00(const HierarchyObjec
             inParallelism = 0;
         }
     }
-    infoRead.push_back(numOutRead);
-    infoRead.push_back(numOutWrite);
-    infoRead.push_back(outParallelism);
-    infoRead.push_back(numInRead);
-    infoRead.push_back(numInWrite);
-    infoRead.push_back(inParallelism);
+    infoRead.infoReadBU[0] = numOutRead;
+    infoRead.infoReadBU[1] = numOutWrite;
+    infoRead.infoReadBU[2] = outParallelism;
+    infoRead.infoReadBU[3] = numInRead;
+    infoRead.infoReadBU[4] = numInWrite;
+    infoRead.infoReadBU[5] = inParallelism;
     
     //*** [STEP5] Update scheduling results ***//
-    infoReadVector.push_back(infoRead);
-
-    return infoReadVector;
+    infoReadTable->PushObject(layerIdx, hObject->hlevel, idxRow, idxCol, infoRead);
 }
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <iostream>
 #include <stdlib.h>
+#include "DesignError.h"
 #include "LayerScheduler.h"
 #include "Param.h"
 
@@ -8,10 +9,11 @@ extern Param *param;
 
 /* HierarchyObject Scheduling 
 * Scheduler type01 - compact mapping */
-vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObject *hObject,
+void LayerScheduler::HObjectScheduling_01(const HierarchyObject *hObject,
                                 double idxRow, double idxCol, 
                                 double numRowObjectAvailable, double numColObjectAvailable,
-                                double wRow, double wCol, double wInC, double wOutC) {
+                                double wRow, double wCol, double wInC, double wOutC,
+                                InfoReadTable *infoReadTable) {
 
     /* Check Mapping option of the kernel - kernel split in spatial dim or channel dim */
     // Row-dim
@@ -94,13 +96,12 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
     int idxType = ( hObject->inputBuffer || spatialColMapping || spatialRowMapping )? 0: 1;
 
     // check if IC info
-    const InterConnect *IC = hObject->interConnect;
+    const InterConnect *IC = hObject->interConnect.get();
     int icOutType = IC->outType;
     int icInType = IC->inType;
     BusMode icInBusMode = IC->inBusMode;
 
     // generate vector
-    vector<vector<double>> infoReadVector;
 
     //*** [STEP1] Scheduling Sub-HierarchyObject ***//
 
@@ -113,8 +114,8 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
     double wInCSubObjectAvailable, wOutCSubObjectAvailable;
     double wInCSubObjectResidual, wOutCSubObjectResidual;
     // for mesh scheduling
-    vector<double> infoReadICIn, infoReadICOut;
-    vector<vector<double>> infoReadICInVector, infoReadICOutVector;
+    InfoReadIC infoReadICIn, infoReadICOut;
+    vector<InfoReadIC> infoReadICInVector, infoReadICOutVector;
     double numOutBitSubObject, numInBitSubObject;
     int prevIdxSubObjectRow;
     double icState = 1; /*reset before update*/
@@ -126,6 +127,16 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
 
     wInC_loop = wInC;
 
+    // weight replication: the layer is mapped numReplicaObject times on the top-level subObjects,
+    // and each replica computes a part of the output rows (numConv/outH are restored for the top-level DE/IC/BU)
+    int numReplicaObject = ( hObject->hlevel == hlevelTop )? numReplica : 1;
+    int idxReplica = 0;
+    double numConvLayer = numConv;
+    double outHLayer = outH;
+    double outHRemained = outH;
+    outH = ceil( outHRemained / numReplicaObject );
+    numConv = outW * outH;
+
     while ( wInC_loop > 0 ) { // NOTE: not working for the systolic array
         // update size of weight matrix assigned for each subObject
         // Row-dim
@@ -134,6 +145,7 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
         if ( spatialRowMapping ) {
             wRowSubObject = 1; // assume only 1 pixel is assigned for spatial dim mapping
             wInCSubObject = wInC;
+            wInCSubObjectAvailable = hObject->numInCSubObject; // each pixel starts a new subObject
             wInCSubObjectResidual = 0;
         } else {
             wRowSubObject = wRow;
@@ -163,6 +175,8 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
             if ( spatialColMapping ) {
                 wColSubObject = 1; // assume only 1 pixel is assigned for spatial dim mapping
                 wOutCSubObject = wOutC;
+                wOutCSubObjectAvailable = hObject->numOutCSubObject;
+                wOutCSubObjectResidual = 0;
             } else {
                 wColSubObject = wCol;
                 if ( (subObjectCol == 0) | (hObject->hlevel == hlevelTop) ) {
@@ -196,40 +210,37 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
             //        (int)wInCSubObject, (int)wOutCSubObject);
 
             // check if the idx is valid
-            if ( (idxSubObjectRow < 0) || (idxSubObjectRow >= hObject->numSubObjectRow) ||
+            // (top-level with linear address is checked with numUsedSubObject_top by the network scheduler)
+            if ( (hObject->hlevel == hlevelTop) && (idxType == 1) ) {
+                numUsedSubObject_top = MAX(numUsedSubObject_top, subObjectCounter + (int)idxOffsetRow + 1);
+            } else if ( (idxSubObjectRow < 0) || (idxSubObjectRow >= hObject->numSubObjectRow) ||
                  (idxSubObjectCol < 0) || (idxSubObjectCol >= hObject->numSubObjectCol) ) {
                 //// debugging
                 //printf("hlevel: %d, idxSubObjectRow: %d, idxSubObjectCol: %d, subObjectCounter: %d\n", 
                 //        hObject->hlevel, idxSubObjectRow, idxSubObjectCol, subObjectCounter);
-                cerr << "[Error] Invalid idxSubObjectRow/Col!" << endl;
-                exit(-1);
+                throw DesignError("subObjectIndex", "Invalid idxSubObjectRow/Col!");
             }
 
             // scheduling sub-object 
             if ( hObject->hlevel == 1 ) {
                 if ( (wRowSubObject > 1) || (wColSubObject > 1) ) {
-                    cerr << "[Error] wRow/Col for hRootObject should be 1!" << endl;
-                    exit(-1);
+                    throw DesignError("rootMapping", "wRow/Col for hRootObject should be 1!");
                 }
-                vector<double> infoReadSub = HRootScheduling( hObject->rootObject, idxSubObjectRow, idxSubObjectCol, 
-                                                            wInCSubObject, wOutCSubObject);
-                infoReadVector.push_back(infoReadSub); // update scheduling result
-                infoReadSub.clear(); // clear updated result
+                HRootScheduling( hObject->rootObject, idxSubObjectRow, idxSubObjectCol, 
+                                wInCSubObject, wOutCSubObject, infoReadTable); // update scheduling result
             } else {
-                vector<vector<double>> infoReadVectorSub 
-                                            = HObjectScheduling_01( hObject->subObject, idxSubObjectRow, idxSubObjectCol, 
-                                                            wInCSubObjectAvailable, wOutCSubObjectAvailable, 
-                                                            wRowSubObject, wColSubObject, wInCSubObject, wOutCSubObject);
-                infoReadVector.insert(infoReadVector.end(), infoReadVectorSub.begin(), infoReadVectorSub.end()); // update
-                infoReadVectorSub.clear(); // clear updated result
+                HObjectScheduling_01( hObject->subObject, idxSubObjectRow, idxSubObjectCol, 
+                                    wInCSubObjectAvailable, wOutCSubObjectAvailable, 
+                                    wRowSubObject, wColSubObject, wInCSubObject, wOutCSubObject,
+                                    infoReadTable); // update scheduling result
             }
 
             // update infoReadIC
-            // (layerIdx, hlevel, idxRow, idxCol, state, dataType, numRead, numHopsRow, numHopsCol, dummy)
+            // (numRead, numHopsRow, numHopsCol, state, dataType)
             if ((icOutType == 2 /*2D Mesh*/) || (icOutType == 3 /*HBus*/)) {
                 numOutBitSubObject = numConv * wOutCSubObject / numCellPerSynapse * hObject->numOutBitSubObject;
-                infoReadICOut = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, icState, 0/*dataType*/,
-                                numOutBitSubObject / IC->outBusWidth, (double)idxSubObjectRow, 0, 0}; // no col dim move of out
+                infoReadICOut = {numOutBitSubObject / IC->outBusWidth, InfoReadField<int16_t>(idxSubObjectRow, "numHopsRow"), 0, // no col dim move of out
+                                InfoReadField<uint8_t>(icState, "icState"), 0/*dataType*/};
                 infoReadICOutVector.push_back(infoReadICOut);
                 icState = 2; /*cumulate*/
             } // infoReadICOut
@@ -245,26 +256,25 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
                     } else {
                         numInBitSubObject = numConv * ( wRowSubObject * wColSubObject * wInCSubObject) * numBitInput;
                     }
-                    infoReadICIn = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2/*icState*/, 1/*dataType*/,
-                                numInBitSubObject / IC->inBusWidth, (double)idxSubObjectRow, (double)idxSubObjectCol};
+                    infoReadICIn = {numInBitSubObject / IC->inBusWidth, InfoReadField<int16_t>(idxSubObjectRow, "numHopsRow"),
+                                InfoReadField<int16_t>(idxSubObjectCol, "numHopsCol"), 2/*icState*/, 1/*dataType*/};
                 } else { // input sharing
                     if ( prevIdxSubObjectRow == idxSubObjectRow ) {
-                        infoReadICIn.back() = MAX(infoReadICIn.back(), idxSubObjectCol); // horizontal & same row -> update the col idx
+                        infoReadICIn.numHopsCol = MAX(infoReadICIn.numHopsCol, idxSubObjectCol); // horizontal & same row -> update the col idx
                     } else { // rowIdx of input changed -> update prev input info & get new row input feeding info
                         if ( (icInType == 3 /*HBus*/) && (prevIdxSubObjectRow % 2 == 0)  ) { // row bus sharing for HBus
-                            infoReadICIn.rbegin()[1] = (double)idxSubObjectRow;
-                            infoReadICIn.back() = MAX(infoReadICIn.back(), idxSubObjectCol);
+                            infoReadICIn.numHopsRow = InfoReadField<int16_t>(idxSubObjectRow, "numHopsRow");
+                            infoReadICIn.numHopsCol = MAX(infoReadICIn.numHopsCol, idxSubObjectCol);
                         }
                         else {
-                            infoReadICIn.push_back(0/*dummy*/);
-                            infoReadICInVector.push_back(infoReadICIn); // NOTE: BUG: Latency should be overlapped
-                            double rowMove = (double)(idxSubObjectRow - prevIdxSubObjectRow);
+                            infoReadICInVector.push_back(infoReadICIn); // (overlapped with the computation when inputOverlap=1)
+                            int rowMove = idxSubObjectRow - prevIdxSubObjectRow;
                             if ( icInType == 2 /*2D Mesh*/ ) {
-                                infoReadICIn = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2, 1/*dataType*/,
-                                        numInBitSubObject / IC->inBusWidth, rowMove, (double)idxSubObjectCol};
+                                infoReadICIn = {numInBitSubObject / IC->inBusWidth, InfoReadField<int16_t>(rowMove, "numHopsRow"),
+                                        InfoReadField<int16_t>(idxSubObjectCol, "numHopsCol"), 2, 1/*dataType*/};
                             } else {
-                                infoReadICIn = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2, 1/*dataType*/,
-                                        numInBitSubObject / IC->inBusWidth, rowMove + 1, (double)idxSubObjectCol};
+                                infoReadICIn = {numInBitSubObject / IC->inBusWidth, InfoReadField<int16_t>(rowMove + 1, "numHopsRow"),
+                                        InfoReadField<int16_t>(idxSubObjectCol, "numHopsCol"), 2, 1/*dataType*/};
                             }
                         }
                     }
@@ -409,7 +419,6 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
 
         // update infoReadICIn
         if ((icInType == 2 /*2D Mesh*/) || (icInType == 3 /*HBus*/)) {
-            infoReadICIn.push_back(0/*dummy*/);
             infoReadICInVector.push_back(infoReadICIn);
         }
 
@@ -417,27 +426,38 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
         subObjectRow = subObjectRow + 1;
         numSubObjectRow = numSubObjectRow + 1;
 
+        // move to the next replica with the remained output rows
+        if ( (wInC_loop <= 0) && (idxReplica + 1 < numReplicaObject) ) {
+            outHRemained = outHRemained - outH;
+            idxReplica = idxReplica + 1;
+            outH = ceil( outHRemained / (numReplicaObject - idxReplica) );
+            numConv = outW * outH;
+            wInC_loop = wInC;
+            subObjectRow = 0;
+            numSubObjectRow = 0;
+        }
+
     }
+    numConv = numConvLayer;
+    outH = outHLayer;
 
 
     // update numUsed SubObject_top
     if ( hObject->hlevel == hlevelTop ) {
-        numUsedSubObject_top = subObjectCounter + idxOffsetRow;
+        numUsedSubObject_top = MAX(numUsedSubObject_top, subObjectCounter + (int)idxOffsetRow);
     } else {
         // check if there was any overflow in the subObject index
         if ( idxType == 0 ) {
             if ( ( (idxSubObjectRow + 1) > hObject->numSubObjectRow ) || ( (idxSubObjectCol + 1) > hObject->numSubObjectCol) ) {
-                cerr << "[ERROR] index of subObject row overflow" << endl;
-                cerr << "last idxSubObjectRow: " << idxSubObjectRow <<  ", subObjectRow: " << hObject->numSubObjectRow << endl;
-                cerr << "last idxSubObjectCol: " << idxSubObjectCol <<  ", subObjectCol: " << hObject->numSubObjectCol << endl;
-                exit(-1);
+                throw DesignError("subObjectOverflow", "index of subObject overflow (last idxSubObjectRow: " + to_string(idxSubObjectRow)
+                                    + ", subObjectRow: " + to_string(hObject->numSubObjectRow) + ", last idxSubObjectCol: " + to_string(idxSubObjectCol)
+                                    + ", subObjectCol: " + to_string(hObject->numSubObjectCol) + ")");
             }
         } else { // idxType == 1
             int numUsedSub = subObjectCounter + idxOffsetRow;
             if ( numUsedSub > hObject->numSubObject ) {
-                cerr << "[ERROR] number of subObject overflow" << endl;
-                cerr << "used numSubObject: " << numUsedSub << ", available numSubObject: " << hObject->numSubObject << endl;
-                exit(-1);
+                throw DesignError("subObjectOverflow", "number of subObject overflow (used numSubObject: " + to_string(numUsedSub)
+                                    + ", available numSubObject: " + to_string(hObject->numSubObject) + ")");
             }
         }
     }
@@ -467,23 +487,14 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
     }
 
     //*** [STEP1] Scheduling Current HierarchyObject ***//
-    vector<double> infoRead; // storage for update scheduling results
+    InfoReadObject infoRead; // storage for update scheduling results
     
     // update object info
-    infoRead.push_back((double)layerIdx);
-    infoRead.push_back((double)hObject->hlevel); // hlevel
-    infoRead.push_back(idxRow); // object row index
-    infoRead.push_back(idxCol); // object col index
-    infoRead.push_back(wRow * wCol * wInC); 
-    infoRead.push_back(wOutC); 
-
-    // update infoReadCIM
-    infoRead.push_back(0);  // numBitInput
-    infoRead.push_back(0);  // numCellPerSynapse
-    infoRead.push_back(0);  // numRead Array
+    infoRead.weightMatrixRow = InfoReadField<uint32_t>(wRow * wCol * wInC, "weightMatrixRow");
+    infoRead.weightMatrixCol = InfoReadField<uint32_t>(wOutC, "weightMatrixCol");
 
     //*** [STEP2] Scheduling DE ***//
-    const DigitalElements *DE = hObject->digitalElements;
+    const DigitalElements *DE = hObject->digitalElements.get();
     double numRead, numUnitAdd;
 
     // number of total output 
@@ -497,8 +508,8 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
         numRead = 0;
         numUnitAdd = 0;
     }
-    infoRead.push_back(numRead);
-    infoRead.push_back(numUnitAdd);
+    infoRead.numReadAdderTree = numRead;
+    infoRead.numUnitAdd = InfoReadField<uint32_t>(numUnitAdd, "numUnitAdd");
 
     // reLu
     if ( DE->placeReLu && (wRow * wCol * wInC == fanIn) && !doneAct) { // has reLu unit & finished MAC operation
@@ -507,7 +518,7 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
     } else {
         numRead = 0;
     }
-    infoRead.push_back(numRead);
+    infoRead.numReadReLu = numRead;
 
     // maxPool
     if ( DE->placeMaxPooling && (doingAct || doneAct) && !doneMaxPool) { // has maxPooling unit & finished MAC operation
@@ -516,7 +527,7 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
     } else {
         numRead = 0;
     }
-    infoRead.push_back(numRead);
+    infoRead.numReadMaxPool = numRead;
     
 
     //*** [STEP3] Scheduling IC ***//
@@ -540,28 +551,30 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
     
     // update infoReadICVector for output
     if ((icOutType == 2 /*2D Mesh*/) || (icOutType == 3 /*HBus*/)) {
-        infoReadVector.insert(infoReadVector.end(), infoReadICOutVector.begin(), infoReadICOutVector.end());
+        for (auto& infoReadIC : infoReadICOutVector) {
+            infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, infoReadIC);
+        }
         infoReadICOutVector.clear();
     } else {
         // numOutRead
         double numOutRead = totalOutBit / IC->outBusWidth;
         
         // update IC infoRead // NOTE:BUG: assume single layer on hObject w/ Linear Array
-        vector<double> tmpInfoReadIC; 
+        InfoReadIC tmpInfoReadIC; 
         if ( IC->outType == 1 /*LinearArray*/) {
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 1/*icState*/, 0/*dataType*/,
-                            numOutRead, (double)numSubObjectRow, (double)numSubObjectCol, 0/*dummy*/};
+            tmpInfoReadIC = {numOutRead, InfoReadField<int16_t>(numSubObjectRow, "numSubObjectRow"),
+                            InfoReadField<int16_t>(numSubObjectCol, "numSubObjectCol"), 1/*icState*/, 0/*dataType*/};
         } else{
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 1/*icState*/, 0/*dataType*/,
-                            numOutRead, 0, 0, 0/*dummy*/};
+            tmpInfoReadIC = {numOutRead, 0, 0, 1/*icState*/, 0/*dataType*/};
         }
-        infoReadVector.push_back(tmpInfoReadIC);
-        tmpInfoReadIC.clear();
+        infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, tmpInfoReadIC);
     }
 
     // update infoReadICVector for input
     if ((icInType == 2 /*2D Mesh*/) || (icInType == 3 /*HBus*/)) {
-        infoReadVector.insert(infoReadVector.end(), infoReadICInVector.begin(), infoReadICInVector.end());
+        for (auto& infoReadIC : infoReadICInVector) {
+            infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, infoReadIC);
+        }
         infoReadICInVector.clear();
     } else {
         double numInRead;
@@ -574,26 +587,19 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
         }
 
         // update IC infoRead // NOTE:BUG: assume single layer on hObject w/ Linear Array
-        vector<double> tmpInfoReadIC; 
+        InfoReadIC tmpInfoReadIC; 
         if ( IC->inType == 1 /*LinearArray*/) {
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2/*icState*/, 1/*dataType*/,
-                            numInRead, (double)numSubObjectRow, (double)numSubObjectCol, 0/*dummy*/};
+            tmpInfoReadIC = {numInRead, InfoReadField<int16_t>(numSubObjectRow, "numSubObjectRow"),
+                            InfoReadField<int16_t>(numSubObjectCol, "numSubObjectCol"), 2/*icState*/, 1/*dataType*/};
         } else{
-            tmpInfoReadIC = {(double)layerIdx, (double)hObject->hlevel, idxRow, idxCol, 2/*icState*/, 1/*dataType*/,
-                            numInRead, 0, 0, 0/*dummy*/};
+            tmpInfoReadIC = {numInRead, 0, 0, 2/*icState*/, 1/*dataType*/};
         }
-        infoReadVector.push_back(tmpInfoReadIC);
-        tmpInfoReadIC.clear();
+        infoReadTable->PushIC(layerIdx, hObject->hlevel, idxRow, idxCol, tmpInfoReadIC);
     }
 
-    // empty IC infoRead
-    vector<double> tmpInfoReadIC = {0, 0, 0, 0, 0, 0};
-    infoRead.insert(infoRead.end(), tmpInfoReadIC.begin(), tmpInfoReadIC.end());
-    tmpInfoReadIC.clear();
-
 
     //*** [STEP4] Scheduling BU ***//
-    const BufferUnit *BU = hObject->bufferUnit;
+    const BufferUnit *BU = hObject->bufferUnit.get();
     double numOutRead, numOutWrite, numInRead, numInWrite, outParallelism, inParallelism;
 
     // get output data size stored in buffer unit (BU)
@@ -642,16 +648,14 @@ vector<vector<double>> LayerScheduler::HObjectScheduling_01(const HierarchyObjec
             inParallelism = 0;
         }
     }
-    infoRead.push_back(numOutRead);
-    infoRead.push_back(numOutWrite);
-    infoRead.push_back(outParallelism);
-    infoRead.push_back(numInRead);
-    infoRead.push_back(numInWrite);
-    infoRead.push_back(inParallelism);
+    infoRead.infoReadBU[0] = numOutRead;
+    infoRead.infoReadBU[1] = numOutWrite;
+    infoRead.infoReadBU[2] = outParallelism;
+    infoRead.infoReadBU[3] = numInRead;
+    infoRead.infoReadBU[4] = numInWrite;
+    infoRead.infoReadBU[5] = inParallelism;
     
     //*** [STEP5] Update scheduling results ***//
-    infoReadVector.push_back(infoRead);
-
-    return infoReadVector;
+    infoReadTable->PushObject(layerIdx, hObject->hlevel, idxRow, idxCol, infoRead);
 }
 
@@ -0,0 +1,202 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include <omp.h>
+#include "MonteCarlo.h"
+#include "Param.h"
+
+extern Param *param;
+
+void MonteCarlo::Initialize(HierarchyRoot *_hRoot, const vector<HierarchyObject*> &hObjectVector,
+                            const InfoReadTable &networkInfoRead) {
+
+    hRoot = _hRoot;
+    columnRes = hRoot->GetColumnResistance(hRoot->inputActiveRatio);
+
+    // number of arrays in an object of each hlevel (arrayPerObject[0] = 1: the array itself)
+    int hlevelTop = hObjectVector.back()->hlevel;
+    vector<long long> arrayPerObject(hlevelTop+1, 1);
+    for ( int h=1; h <= hlevelTop; h++ ) {
+        arrayPerObject[h] = arrayPerObject[h-1] * hObjectVector[h-1]->numSubObject;
+    }
+
+    // array operations of the schedule & the position of their array in the hierarchy
+    // (records of the subObjects come before the record of their parent object, so the reads found under
+    //  the subObjects are collected in pendingRead[hlevel of subObject] and offset by the parent index)
+    map<ArrayKey, int> keyMap;
+    keyVector.clear();
+    arrayReadVector.clear();
+    vector<long long> arrayPosition;
+    vector<vector<int>> pendingRead(hlevelTop+1);
+    int layerIdx = -1;
+    for ( int infoIdx=0; infoIdx < networkInfoRead.Size(); infoIdx++ ) {
+        const InfoRead &infoRead = networkInfoRead.header[infoIdx];
+        if ( infoRead.layerIdx != layerIdx ) {
+            for ( auto &read : pendingRead ) { read.clear(); }
+            layerIdx = infoRead.layerIdx;
+        }
+        if ( infoRead.type == INFOREAD_IC ) { continue; }
+        int hlevel = infoRead.hlevel;
+
+        vector<int> read;
+        if ( infoRead.type == INFOREAD_ROOT ) {
+            vector<double> infoReadHRoot = networkInfoRead.GetInfoReadHRoot(infoIdx);
+            ArrayKey key = make_tuple(infoReadHRoot[0], infoReadHRoot[1], infoReadHRoot[2]);
+            auto it = keyMap.find(key);
+            if ( it == keyMap.end() ) {
+                it = keyMap.insert(make_pair(key, (int)keyVector.size())).first;
+                keyVector.push_back(key);
+            }
+            read.push_back(arrayReadVector.size());
+            arrayReadVector.push_back({it->second, -1, ceil(infoReadHRoot[4])});
+            arrayPosition.push_back(0);
+        } else {
+            read.swap(pendingRead[hlevel-1]);
+        }
+        if ( hlevel < hlevelTop ) {
+            long long idxObject = (long long)infoRead.idxRow * hObjectVector[hlevel]->numSubObjectCol + infoRead.idxCol;
+            for ( auto readIdx : read ) {
+                arrayPosition[readIdx] += idxObject * arrayPerObject[hlevel];
+            }
+            pendingRead[hlevel].insert(pendingRead[hlevel].end(), read.begin(), read.end());
+        }
+    }
+    map<long long, int> arrayMap;
+    for ( int readIdx=0; readIdx < arrayReadVector.size(); readIdx++ ) {
+        auto it = arrayMap.insert(make_pair(arrayPosition[readIdx], (int)arrayMap.size())).first;
+        arrayReadVector[readIdx].arrayIdx = it->second;
+    }
+    numArray = arrayMap.size();
+
+    // the array is evaluated on a grid of the column resistance (+-6 sigma of the total variation)
+    // so that the samples only interpolate the tables
+    double sigma = sqrt(param->sigmaResistance * param->sigmaResistance + param->readNoise * param->readNoise);
+    numGrid = 65;
+    gridStep = MAX(6 * sigma, 1e-6) / ((numGrid - 1) / 2);
+    energyTable.assign(keyVector.size(), vector<double>(numGrid, 0));
+    latencyTable.assign(keyVector.size(), vector<double>(numGrid, 0));
+    for ( int keyIdx=0; keyIdx < keyVector.size(); keyIdx++ ) {
+        double weightMatrixRow = get<0>(keyVector[keyIdx]);
+        double weightMatrixCol = get<1>(keyVector[keyIdx]);
+        double numBitInput = get<2>(keyVector[keyIdx]);
+        for ( int grid=0; grid < numGrid; grid++ ) {
+            double colR = columnRes * exp((grid - (numGrid - 1) / 2) * gridStep) * ( weightMatrixRow / hRoot->numRow );
+            hRoot->cimArray->CalculatePower(colR, weightMatrixRow, weightMatrixCol, numBitInput, hRoot->inputActiveRatio);
+            energyTable[keyIdx][grid] = hRoot->cimArray->readDynamicEnergyADC;
+            hRoot->cimArray->CalculateLatency(colR, weightMatrixRow, weightMatrixCol, numBitInput, true);
+            latencyTable[keyIdx][grid] = hRoot->cimArray->readLatency;
+        }
+    }
+
+    // nominal device
+    nominalEnergy = 0;
+    nominalLatency = 0;
+    for ( auto &arrayRead : arrayReadVector ) {
+        nominalEnergy += energyTable[arrayRead.keyIdx][(numGrid - 1) / 2] * arrayRead.numRead;
+        nominalLatency = MAX(nominalLatency, latencyTable[arrayRead.keyIdx][(numGrid - 1) / 2]);
+    }
+
+}
+
+void MonteCarlo::Run(int numSample) {
+
+    energyVector.assign(numSample, 0);
+    latencyVector.assign(numSample, 0);
+
+    // Ron/Roff spread (lognormal, per physical array) & read noise (independent in each read of the array)
+    double sigmaResistance = param->sigmaResistance;
+    double readNoise = param->readNoise;
+    int gridCenter = (numGrid - 1) / 2;
+
+    // the read noise is integrated over (5-point Gauss-Hermite rule of the standard normal), so a record of numRead
+    // reads takes the mean & variance of a single read, and its energy is a sum of numRead independent reads
+    const int numNode = 5;
+    const double node[numNode] = {-2.856970013872806, -1.355626179974266, 0, 1.355626179974266, 2.856970013872806};
+    const double nodeWeight[numNode] = {0.011257411327721, 0.222075922005613, 0.533333333333333,
+                                        0.222075922005613, 0.011257411327721};
+
+    #pragma omp parallel for schedule(dynamic)
+    for ( int sample=0; sample < numSample; sample++ ) {
+        // RNG stream of the sample (results do not depend on the number of threads)
+        seed_seq seed{param->monteCarloSeed, sample};
+        mt19937 gen(seed);
+        normal_distribution<double> normal(0, 1);
+
+        // the devices of an array keep their variation in every read of the array
+        vector<double> scaleOn(numArray), scaleOff(numArray);
+        for ( int arrayIdx=0; arrayIdx < numArray; arrayIdx++ ) {
+            scaleOn[arrayIdx] = exp(sigmaResistance * normal(gen));
+            scaleOff[arrayIdx] = exp(sigmaResistance * normal(gen));
+        }
+
+        // position of each array on the table at the nodes of the read noise (clamped at +-6 sigma)
+        vector<double> gridPos(numArray * numNode);
+        for ( int arrayIdx=0; arrayIdx < numArray; arrayIdx++ ) {
+            double colR = hRoot->GetColumnResistance(hRoot->inputActiveRatio, scaleOn[arrayIdx], scaleOff[arrayIdx]);
+            for ( int n=0; n < numNode; n++ ) {
+                double noise = MAX(1 + readNoise * node[n], 0.1);
+                double pos = log(colR / noise / columnRes) / gridStep + gridCenter;
+                gridPos[arrayIdx * numNode + n] = MIN(MAX(pos, 0.0), numGrid - 1.0);
+            }
+        }
+
+        double energy = 0, latency = 0;
+        for ( auto &arrayRead : arrayReadVector ) {
+            // linear interpolation on the table, mean & variance of a read over the read noise
+            const vector<double> &energyRow = energyTable[arrayRead.keyIdx];
+            const vector<double> &latencyRow = latencyTable[arrayRead.keyIdx];
+            double readEnergy = 0, readEnergy2 = 0, readLatency = 0;
+            for ( int n=0; n < numNode; n++ ) {
+                double pos = gridPos[arrayRead.arrayIdx * numNode + n];
+                int grid = MIN((int)pos, numGrid - 2);
+                double w = pos - grid;
+                double e = (1 - w) * energyRow[grid] + w * energyRow[grid+1];
+                readEnergy += nodeWeight[n] * e;
+                readEnergy2 += nodeWeight[n] * e * e;
+                readLatency += nodeWeight[n] * ( (1 - w) * latencyRow[grid] + w * latencyRow[grid+1] );
+            }
+            // sum of numRead reads (normal approximation, std grows with sqrt(numRead))
+            double readStd = sqrt(MAX(readEnergy2 - readEnergy * readEnergy, 0.0));
+            energy += MAX(readEnergy * arrayRead.numRead + readStd * sqrt(arrayRead.numRead) * normal(gen), 0.0);
+            latency = MAX(latency, readLatency);
+        }
+        energyVector[sample] = energy;
+        latencyVector[sample] = latency;
+    }
+
+}
+
+/* mean, std, 5/50/95th percentile */
+static vector<double> GetStatistics(vector<double> samples) {
+    double mean = 0, var = 0;
+    for ( auto s : samples ) { mean += s; }
+    mean /= samples.size();
+    for ( auto s : samples ) { var += (s - mean) * (s - mean); }
+    var /= MAX((int)samples.size() - 1, 1);
+    sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) { return samples[(int)round(p * (samples.size() - 1))]; };
+    return {mean, sqrt(var), percentile(0.05), percentile(0.5), percentile(0.95)};
+}
+
+void MonteCarlo::PrintResult() {
+    if ( energyVector.size() == 0 ) { return; }
+    vector<double> energy = GetStatistics(energyVector);
+    vector<double> latency = GetStatistics(latencyVector);
+    printf("---------- Monte Carlo (%d samples, %d array reads on %d arrays) ----------\n", (int)energyVector.size(),
+           (int)arrayReadVector.size(), numArray);
+    printf("%-20s %10s %12s %12s %12s %12s %12s\n", "", "nominal", "mean", "std", "p5", "p50", "p95");
+    printf("%-20s %10.4e %12.4e %12.4e %12.4e %12.4e %12.4e pJ\n", "ADC energy", nominalEnergy*1e12,
+            energy[0]*1e12, energy[1]*1e12, energy[2]*1e12, energy[3]*1e12, energy[4]*1e12);
+    printf("%-20s %10.4e %12.4e %12.4e %12.4e %12.4e %12.4e ns\n", "Sensing latency", nominalLatency*1e9,
+            latency[0]*1e9, latency[1]*1e9, latency[2]*1e9, latency[3]*1e9, latency[4]*1e9);
+}
+
+void MonteCarlo::SaveCSV(const string &filename) {
+    ofstream out(filename);
+    out << "sample,ADC energy (pJ),sensing latency (ns)\n";
+    for ( int sample=0; sample < energyVector.size(); sample++ ) {
+        out << sample << ',' << energyVector[sample]*1e12 << ',' << latencyVector[sample]*1e9 << '\n';
+    }
+}
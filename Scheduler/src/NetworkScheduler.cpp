@@ -2,6 +2,8 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <set>
+#include "DesignError.h"
 #include "LayerScheduler.h"
 #include "NetworkScheduler.h"
 #include "Param.h"
@@ -9,7 +11,7 @@
 extern Param *param;
 
 NetworkScheduler::NetworkScheduler() {
-    int hlevelMappingUnit = 2; // TILE
+    hlevelMappingUnit = 2; // TILE
 }
 
 void NetworkScheduler::Initialize(const vector<vector<double>> _networkStructure,
@@ -21,78 +23,94 @@ void NetworkScheduler::Initialize(const vector<vector<double>> _networkStructure
     hTop = _hTop;
     // initialize numUsedSubObject_top
     numUsedSubObject_top = 0;
+    // no weight replication
+    numReplicaVector.assign(numLayer, 1);
 }
 
-vector<vector<double>> NetworkScheduler::Scheduling(int scheduler_type) {
+const InfoReadTable& NetworkScheduler::Scheduling(int scheduler_type) {
+
+    if ( scheduler_type == 0 ) {
+        printf("non-compact mapping!\n");
+    } else if ( scheduler_type == 1 ) {
+        printf("compact mapping!\n");
+    }
+
+    // map the network with the weight replicas of numReplicaVector
+    MapNetwork(scheduler_type);
+    if ( numUsedSubObject_top > hTop->numSubObject ) {
+        throw DesignError("topOverflow", "number of top-level subObject overflow (used: " + to_string(numUsedSubObject_top)
+                          + ", available: " + to_string(hTop->numSubObject) + ")");
+    }
+
+    return networkInfoRead;
+
+}
+
+void NetworkScheduler::MapNetwork(int scheduler_type) {
 
     // clear scheduling result
-    networkInfoRead.clear();
+    networkInfoRead.Clear();
     // clear numUsedSubObject_top
     numUsedSubObject_top = 0;
 
     // define layer scheduler
-    LayerScheduler *layerScheduler = new LayerScheduler();
+    LayerScheduler layerScheduler;
     vector<vector<int>> idxOffsetVector;
     bool offsetObject = false;
 
     if ( scheduler_type == 0 ) {
-        printf("non-compact mapping!\n");
         for (int layerIdx=0; layerIdx < numLayer; layerIdx++) {
 
             // initialzie layer scheduler
             vector<double> layerStructure = networkStructure[layerIdx];
-            layerScheduler->Initialize(layerIdx, layerStructure, hlevelMappingUnit, idxOffsetVector, hTop);
+            layerScheduler.Initialize(layerIdx, layerStructure, hlevelMappingUnit, idxOffsetVector, hTop,
+                                      numReplicaVector[layerIdx]);
         
-            // layer scheduling 
-            vector<vector<double>> layerInfoRead;
-            layerInfoRead = layerScheduler->HObjectScheduling_00(hTop, 0, 0, 
-                                                            layerScheduler->kH, layerScheduler->kW, layerScheduler->inC,
-                                                            layerScheduler->outC * layerScheduler->numCellPerSynapse,
-                                                            offsetObject, true);
+            // layer scheduling (update layer info)
+            layerScheduler.HObjectScheduling_00(hTop, 0, 0, 
+                                            layerScheduler.kH, layerScheduler.kW, layerScheduler.inC,
+                                            layerScheduler.outC * layerScheduler.numCellPerSynapse,
+                                            offsetObject, true, &networkInfoRead);
             // get used #top subObject
-            numUsedSubObject_top = MAX(numUsedSubObject_top, layerScheduler->numUsedSubObject_top);
-
-            // get layer info
-            networkInfoRead.insert(networkInfoRead.end(), layerInfoRead.begin(), layerInfoRead.end()); // update
-            layerInfoRead.clear(); // clear updated result
+            numUsedSubObject_top = MAX(numUsedSubObject_top, layerScheduler.numUsedSubObject_top);
 
             // get offset info
             idxOffsetVector.clear();
-            if ( layerScheduler->nextIdxOffsetVector.size() > 0 ) {
+            if ( layerScheduler.nextIdxOffsetVector.size() > 0 ) {
                 offsetObject = true;
-                idxOffsetVector.assign(layerScheduler->nextIdxOffsetVector.begin(), layerScheduler->nextIdxOffsetVector.end());
-                layerScheduler->nextIdxOffsetVector.clear();
+                idxOffsetVector.assign(layerScheduler.nextIdxOffsetVector.begin(), layerScheduler.nextIdxOffsetVector.end());
+                layerScheduler.nextIdxOffsetVector.clear();
             } else {
                 offsetObject = false;
             }
         
         }
     } else if ( scheduler_type == 1 ) {
-        printf("compact mapping!\n");
         for (int layerIdx=0; layerIdx < numLayer; layerIdx++) {
 
             //printf("layer %d\n", layerIdx);
 
             // initialzie layer scheduler
             vector<double> layerStructure = networkStructure[layerIdx];
-            layerScheduler->Initialize(layerIdx, layerStructure, hlevelMappingUnit, idxOffsetVector, hTop);
+            layerScheduler.Initialize(layerIdx, layerStructure, hlevelMappingUnit, idxOffsetVector, hTop,
+                                      numReplicaVector[layerIdx]);
         
-            // layer scheduling 
-            vector<vector<double>> layerInfoRead;
-            layerInfoRead = layerScheduler->HObjectScheduling_01(hTop, 0, 0, -1, -1,
-                                                            layerScheduler->kH, layerScheduler->kW, layerScheduler->inC,
-                                                            layerScheduler->outC * layerScheduler->numCellPerSynapse);
+            // layer scheduling (update layer info)
+            layerScheduler.HObjectScheduling_01(hTop, 0, 0, -1, -1,
+                                            layerScheduler.kH, layerScheduler.kW, layerScheduler.inC,
+                                            layerScheduler.outC * layerScheduler.numCellPerSynapse,
+                                            &networkInfoRead);
 
             //// print scheduling data
             //if ( layerIdx < 3 ) {
-            //    int numRow = layerInfoRead.size();
+            //    int numRow = networkInfoRead.Size();
             //    printf("length layerInfoRead: %d\n", numRow);
             //    vector<double> tmpVector;
             //    int numCol; 
             //    double tmpData;
             //    for ( int vecIdx=0; vecIdx < numRow; vecIdx++ ) {
 
-            //        tmpVector = layerInfoRead.at(vecIdx);
+            //        tmpVector = networkInfoRead.GetInfoRead(vecIdx);
             //        int numCol = tmpVector.size(); // data of vector on Col dim
 
             //        // get & print components
@@ -106,20 +124,16 @@ vector<vector<double>> NetworkScheduler::Scheduling(int scheduler_type) {
             //}
 
             // get used #top subObject
-            numUsedSubObject_top = MAX(numUsedSubObject_top, layerScheduler->numUsedSubObject_top);
-
-            // get layer info
-            networkInfoRead.insert(networkInfoRead.end(), layerInfoRead.begin(), layerInfoRead.end()); // update
-            layerInfoRead.clear(); // clear updated result
+            numUsedSubObject_top = MAX(numUsedSubObject_top, layerScheduler.numUsedSubObject_top);
 
             // get offset info
             idxOffsetVector.clear();
-            if ( layerScheduler->nextIdxOffsetVector.size() > 0 ) {
+            if ( layerScheduler.nextIdxOffsetVector.size() > 0 ) {
                 vector<vector<int>> tmp_idxOffsetVector;
                 vector<int> tmp;
-                tmp_idxOffsetVector.assign(layerScheduler->nextIdxOffsetVector.begin(), 
-                                           layerScheduler->nextIdxOffsetVector.end());
-                layerScheduler->nextIdxOffsetVector.clear();
+                tmp_idxOffsetVector.assign(layerScheduler.nextIdxOffsetVector.begin(), 
+                                           layerScheduler.nextIdxOffsetVector.end());
+                layerScheduler.nextIdxOffsetVector.clear();
                 // reorder the idxOffstVector
                 while ( tmp_idxOffsetVector.size() > 0 ) {
                     tmp = tmp_idxOffsetVector.back();
@@ -150,17 +164,111 @@ vector<vector<double>> NetworkScheduler::Scheduling(int scheduler_type) {
         }
     }
 
+}
+
+void NetworkScheduler::BalanceReplica(int scheduler_type, HierarchyRoot *hRoot,
+                                      const vector<HierarchyObject*> &hObjectVector) {
+
+    numReplicaVector.assign(numLayer, 1);
+    if ( scheduler_type != 1 ) {
+        printf("weight replication is supported with compact mapping only\n");
+        return;
+    }
+
+    // layer info: output size & replicable or not
+    LayerScheduler layerScheduler;
+    vector<vector<int>> idxOffsetVector;
+    vector<double> outHVector;
+    vector<bool> replicableVector;
+    for (int layerIdx=0; layerIdx < numLayer; layerIdx++) {
+        layerScheduler.Initialize(layerIdx, networkStructure[layerIdx], hlevelMappingUnit, idxOffsetVector, hTop, 1);
+        outHVector.push_back(layerScheduler.outH);
+        replicableVector.push_back(layerScheduler.replicable);
+    }
+
+    // mapping w/o replication
+    vector<double> layerSubLatency;
+    MapNetwork(scheduler_type);
+    double latency = MappingLatency(hRoot, hObjectVector, &layerSubLatency);
 
-    // write scheduling results to the csv file
-    ofstream out("scheduling_result.csv");
-    for (auto& row : networkInfoRead) {
-        for (auto col : row) {
-            out << col << ',';
+    // area budget: #top-level subObjects available for the replicas
+    int numSubObjectBase = numUsedSubObject_top;
+    int numSubObjectLimit = MIN(hTop->numSubObject, (int)floor(numSubObjectBase * (1 + param->replicaBudget)));
+
+    // greedy balancing: add a replica to the layer with the longest subObject latency that reduces the latency
+    // (pipeline interval in pipeline process), and stop when no more replica helps or fits in the budget
+    bool replicated = true;
+    while ( replicated ) {
+        replicated = false;
+
+        // layer order by subObject latency
+        vector<int> layerOrder;
+        for (int layerIdx=0; layerIdx < numLayer; layerIdx++) {
+            int orderIdx = 0;
+            while ( (orderIdx < layerOrder.size()) && (layerSubLatency[layerOrder[orderIdx]] >= layerSubLatency[layerIdx]) ) {
+                orderIdx++;
+            }
+            layerOrder.insert(layerOrder.begin() + orderIdx, layerIdx);
+        }
+
+        for (auto layerIdx : layerOrder) {
+            if ( !replicableVector[layerIdx] || (numReplicaVector[layerIdx] >= outHVector[layerIdx]) ) {
+                continue;
+            }
+            // try one more replica (compact mapping of the following layers changes as well)
+            numReplicaVector[layerIdx] += 1;
+            MapNetwork(scheduler_type);
+            if ( numUsedSubObject_top <= numSubObjectLimit ) {
+                vector<double> tmpLayerSubLatency;
+                double tmpLatency = MappingLatency(hRoot, hObjectVector, &tmpLayerSubLatency);
+                if ( tmpLatency < latency ) {
+                    latency = tmpLatency;
+                    layerSubLatency = tmpLayerSubLatency;
+                    replicated = true;
+                    break;
+                }
+            }
+            numReplicaVector[layerIdx] -= 1;
+            MapNetwork(scheduler_type);
         }
-        out << '\n';
     }
 
-    return networkInfoRead;
+    printf("weight replication (used top-level subObject: %d -> %d)\n", numSubObjectBase, numUsedSubObject_top);
+    for (int layerIdx=0; layerIdx < numLayer; layerIdx++) {
+        if ( numReplicaVector[layerIdx] > 1 ) {
+            printf("    layer %d: %d replicas\n", layerIdx, numReplicaVector[layerIdx]);
+        }
+    }
+
+}
+
+/* latency of the current mapping (pipeline interval in pipeline process) & subObject latency of each layer */
+double NetworkScheduler::MappingLatency(HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector,
+                                        vector<double> *layerSubLatency) {
+
+    vector<vector<double>> networkLatencyVector, networkEnergyVector;
+    vector<vector<double>> layerLatencyVector2, layerEnergyVector2, networkLatencyVector2, networkEnergyVector2;
+    CalculatePerformance(&networkLatencyVector, &networkEnergyVector,
+                         &layerLatencyVector2, &layerEnergyVector2,
+                         &networkLatencyVector2, &networkEnergyVector2,
+                         hRoot, hObjectVector, networkInfoRead);
+
+    layerSubLatency->assign(numLayer, 0);
+    for ( auto& layerLatency : layerLatencyVector2 ) { // layerIdx, hlevel, total, sub, ...
+        if ( (int)layerLatency[1] == hTop->hlevel ) {
+            (*layerSubLatency)[(int)layerLatency[0]] = layerLatency[3];
+        }
+    }
+
+    if ( param->pipeline ) {
+        CalculatePipeline(&layerLatencyVector2);
+        return pipelineInterval;
+    }
+    double latency = 0;
+    for ( auto& layerLatency : networkLatencyVector ) {
+        latency += layerLatency[0];
+    }
+    return latency;
 
 }
 
@@ -171,8 +279,8 @@ void NetworkScheduler::CalculatePerformance(
                         vector<vector<double>> *layerEnergyVector2,
                         vector<vector<double>> *networkLatencyVector2,
                         vector<vector<double>> *networkEnergyVector2,
-                        HierarchyRoot *hRoot, vector<HierarchyObject*> hObjectVector,
-                        const vector<vector<double>> networkInfoRead) {
+                        HierarchyRoot *hRoot, const vector<HierarchyObject*> &hObjectVector,
+                        const InfoReadTable &networkInfoRead) {
 
     // space for keeping network latency results
     networkLatencyVector->clear(); 
@@ -181,6 +289,7 @@ void NetworkScheduler::CalculatePerformance(
     layerEnergyVector2->clear();
     networkLatencyVector2->clear();
     networkEnergyVector2->clear();
+    topSubObjectLatency.assign(hTop->numSubObject, 0);
 
     // for keeping latency & energy information
     vector<int> hlevelHeap; // layer-wise info
@@ -194,9 +303,9 @@ void NetworkScheduler::CalculatePerformance(
     map<int, vector<double>> totalLatencyDict2, totalEnergyDict2; // hlevel, latency/energy breakdown
 
     // get required info
-    int numInfoRead = networkInfoRead.size(); // number of calculation
-    int layerIdx = (int)networkInfoRead[0][0]; // layer index of the first infoRead
-    int hlevel = (int)networkInfoRead[0][1]; // hlevel of the first infoRead
+    int numInfoRead = networkInfoRead.Size(); // number of calculation
+    int layerIdx = networkInfoRead.header[0].layerIdx; // layer index of the first infoRead
+    int hlevel = networkInfoRead.header[0].hlevel; // hlevel of the first infoRead
     int layerHlevel = 0;
 
     // get latency information for each operation
@@ -204,19 +313,19 @@ void NetworkScheduler::CalculatePerformance(
 
         //printf("infoIdx: %d\n", infoIdx);
 
-        vector<double> infoRead = networkInfoRead[infoIdx];
+        const InfoRead *infoRead = &networkInfoRead.header[infoIdx];
 
         //printf("1\n");
 
         // check if moved to the other hierarchy
-        if ( (int)infoRead[1] != hlevel ) {
+        if ( (int)infoRead->hlevel != hlevel ) {
 
             // clear sub latency/energy
             subLatencyVector.clear();
             subEnergyVector.clear();
 
             // update layer-wise & sub latency/energy info
-            if ( (int)infoRead[1] == 0 ) { // go back to root
+            if ( (int)infoRead->hlevel == 0 ) { // go back to root
                 // update latency/energy heap
                 if ( (hlevelHeap.size() == 0) || (hlevelHeap.back() > hlevel) ) { // update new hlevel object (size==0 -> highest)
                     // push_back heap
@@ -240,8 +349,7 @@ void NetworkScheduler::CalculatePerformance(
                     latencyHeap.push_back(tmpLatencyVector);
                     energyHeap.push_back(tmpEnergyVector);
                 } else { 
-                    cerr << "[CalculateNetworkPerformance] Unexpected Pattern for Heap" << endl;
-                    exit(-1);
+                    throw DesignError("heapPattern", "[CalculateNetworkPerformance] Unexpected Pattern for Heap");
                 }
             } else { // go to the next hierarhcy
                 if ( (hlevelHeap.size() == 0) || (hlevelHeap.back() > hlevel) ) { // local scanning (initial || hlevel=0)
@@ -265,8 +373,7 @@ void NetworkScheduler::CalculatePerformance(
                         subEnergyVector.push_back( tmpEnergy );
                     }
                 } else {
-                    cerr << "[CalculateNetworkPerformance] Unexpected Pattern for Heap" << endl;
-                    exit(-1);
+                    throw DesignError("heapPattern", "[CalculateNetworkPerformance] Unexpected Pattern for Heap");
                 }
             }
 
@@ -297,13 +404,13 @@ void NetworkScheduler::CalculatePerformance(
             
 
             // move to the next hierarchy
-            hlevel = infoRead[1];
+            hlevel = infoRead->hlevel;
         }
 
         //printf("2\n");
 
         // check if moved to next layer operation
-        if ( (int)infoRead[0] != layerIdx ) {
+        if ( (int)infoRead->layerIdx != layerIdx ) {
             //printf("2-1\n");
             //printf("size: %d %d %d %d\n", networkLatencyVector->size(), latencyHeap.size(), networkEnergyVector->size(), energyHeap.size());
             // update latency/Energy info
@@ -358,7 +465,7 @@ void NetworkScheduler::CalculatePerformance(
 
             //printf("2-5\n");
             // move to next layer
-            layerIdx = infoRead[0];
+            layerIdx = infoRead->layerIdx;
         }
 
         //printf("3\n");
@@ -366,7 +473,7 @@ void NetworkScheduler::CalculatePerformance(
         // get Performance info
         if ( hlevel == 0 ) {
             // get infoRead
-            vector<double> infoReadHRoot {&infoRead[4], &infoRead[9]};
+            vector<double> infoReadHRoot = networkInfoRead.GetInfoReadHRoot(infoIdx);
             // Calculate Latency
             hRoot->CalculateLatency(infoReadHRoot);
             tmpLatencyVector = hRoot->latencyVector;
@@ -375,20 +482,20 @@ void NetworkScheduler::CalculatePerformance(
             tmpEnergyVector = hRoot->readDynamicEnergyVector;
         } else {
             HierarchyObject *hObject = hObjectVector[hlevel-1];
-            if ( infoRead.size() == param->lengthInfoReadForIC ) { // get IC performance
-                while ( infoRead.size() == param->lengthInfoReadForIC) {
-                    vector<double> infoReadIC {&infoRead[4], &infoRead[10]};
+            if ( infoRead->type == INFOREAD_IC ) { // get IC performance
+                while ( infoRead->type == INFOREAD_IC ) {
+                    vector<double> infoReadIC = networkInfoRead.GetInfoReadIC(infoIdx);
                     // Calculate IC Latency
                     hObject->CalculateICLatency(infoReadIC); 
                     // Calculate IC Energy
                     hObject->CalculateICPower(infoReadIC);
                     // get next infoRead
                     infoIdx += 1; 
-                    infoRead = networkInfoRead[infoIdx];
+                    infoRead = &networkInfoRead.header[infoIdx];
                 }
             }
             // get info Read
-            vector<double> infoReadHObject {&infoRead[9], &infoRead[25]};
+            vector<double> infoReadHObject = networkInfoRead.GetInfoReadHObject(infoIdx);
             // Calculate Latency
             hObject->CalculateLatency(infoReadHObject, subLatencyVector);
             tmpLatencyVector = hObject->latencyVector;
@@ -400,6 +507,11 @@ void NetworkScheduler::CalculatePerformance(
         }
 
 
+        // busy time of the top-level subObjects
+        if ( hlevel == hTop->hlevel - 1 ) {
+            topSubObjectLatency[infoRead->idxRow * hTop->numSubObjectCol + infoRead->idxCol] += tmpLatencyVector[0];
+        }
+
         //printf("4\n");
 
         // update Performance for breakdown type1
@@ -460,8 +572,7 @@ void NetworkScheduler::CalculatePerformance(
         latencyHeap.push_back(tmpLatencyVector);
         energyHeap.push_back(tmpEnergyVector);
     } else { 
-        cerr << "[CalculateNetworkPerformance] Unexpected Pattern for Heap" << endl;
-        exit(-1);
+        throw DesignError("heapPattern", "[CalculateNetworkPerformance] Unexpected Pattern for Heap");
     }
     // clear temporary vectors
     subLatencyVector.clear();
@@ -550,3 +661,156 @@ void NetworkScheduler::CalculatePerformance(
     totalEnergyDict2.clear();
 }
 
+
+void NetworkScheduler::CalculatePipeline(const vector<vector<double>> *layerLatencyVector2) {
+
+    pipelineStageVector.clear();
+
+    // each layer is a stage: its subObjects at the top run concurrently with the other stages,
+    // while the top-level units (DE/BU/IC) are shared by all stages
+    pipelineSharedLatency = 0;
+    for ( auto& layerLatency : *layerLatencyVector2 ) { // layerIdx, hlevel, total, sub, accum, buffer, ic, other
+        if ( (int)layerLatency[1] == hTop->hlevel ) {
+            vector<double> stage = {layerLatency[0], layerLatency[3], layerLatency[2] - layerLatency[3]};
+            pipelineStageVector.push_back(stage);
+            pipelineSharedLatency += stage[2];
+        }
+    }
+
+    // top-level subObject shared by multiple layers (compact mapping) runs their parts sequentially
+    pipelineBottleneck = -1;
+    pipelineInterval = pipelineSharedLatency;
+    for ( int idxSubObject=0; idxSubObject < topSubObjectLatency.size(); idxSubObject++ ) {
+        if ( topSubObjectLatency[idxSubObject] > pipelineInterval ) {
+            pipelineInterval = topSubObjectLatency[idxSubObject];
+            pipelineBottleneck = idxSubObject;
+        }
+    }
+
+    // each image moves forward by one stage every interval
+    pipelineLatency = pipelineInterval * pipelineStageVector.size();
+
+}
+
+void NetworkScheduler::CalculateBatch(int batchSize, double imageLatency) {
+
+    // an image waiting between stages keeps the input feature map of its next layer in the top-level buffer
+    fmapBit = 0;
+    for ( int layerIdx=0; layerIdx < numLayer; layerIdx++ ) {
+        vector<double> layerStructure = networkStructure[layerIdx];
+        double numBitInput = ( layerStructure.size() > 10 )? layerStructure[10] : param->numBitInput;
+        fmapBit = MAX(fmapBit, layerStructure[0] * layerStructure[1] * layerStructure[2] * numBitInput);
+    }
+    double bufferBit = hTop->bufferUnit->outBUSize + hTop->bufferUnit->inBUSize;
+
+    // images processed concurrently: as many as the top-level buffer holds the feature maps of
+    // (in pipeline process, at most one per stage)
+    numImageInFlight = MAX(1, (int)floor(bufferBit / fmapBit));
+    if ( param->pipeline ) {
+        numImageInFlight = MIN(numImageInFlight, (int)pipelineStageVector.size());
+    }
+    numImageInFlight = MIN(numImageInFlight, batchSize);
+
+    if ( param->pipeline && (numImageInFlight > 1) ) {
+        // the first image passes all the stages (pipeline latency) and the next ones follow at the pipeline interval,
+        // stalled when the stages (imageLatency in total) are busy with fewer images than stages
+        batchInterval = MAX(pipelineInterval, imageLatency / numImageInFlight);
+        batchLatency = pipelineLatency + (batchSize - 1) * batchInterval;
+    } else {
+        // layer by layer, each layer runs the images of a group back to back with its weights kept in the arrays,
+        // so its subObjects take the next image while the top-level DE/BU/IC finish the previous one
+        // (group: the images the top-level buffer holds, without room for a second image the pipeline stalls as well)
+        double imageReuseLatency = 0;
+        for ( auto& stage : pipelineStageVector ) { // layerIdx, subObject latency, top-level latency
+            imageReuseLatency += MAX(stage[1], stage[2]);
+        }
+        int numGroup = batchSize / numImageInFlight;
+        int numImageLast = batchSize % numImageInFlight;
+        batchLatency = numGroup * (imageLatency + (numImageInFlight - 1) * imageReuseLatency);
+        if ( numImageLast > 0 ) {
+            batchLatency += imageLatency + (numImageLast - 1) * imageReuseLatency;
+        }
+        batchInterval = batchLatency / batchSize;
+    }
+
+}
+
+double NetworkScheduler::CalculatePowerGating(double chipLeakage, HierarchyRoot *hRoot,
+                        const vector<HierarchyObject*> &hObjectVector, const InfoReadTable &networkInfoRead,
+                        const vector<vector<double>> *networkLatencyVector) {
+
+    int hlevelGating = param->powerGatingLevel; // 0: array (hRoot), 1~: hObject
+    int hlevelTop = hTop->hlevel;
+    if ( (hlevelGating < 0) || (hlevelGating >= hlevelTop) ) {
+        throw DesignError("powerGatingLevel", "powerGatingLevel should be in [0, " + to_string(hlevelTop-1) + "]");
+    }
+
+    // number of gated units in an object of each hlevel (unitPerObject[hlevelGating] = 1: the unit itself)
+    vector<long long> unitPerObject(hlevelTop+1, 1);
+    for ( int h=hlevelGating+1; h <= hlevelTop; h++ ) {
+        unitPerObject[h] = unitPerObject[h-1] * hObjectVector[h-1]->numSubObject;
+    }
+    numGatingUnit = unitPerObject[hlevelTop];
+    double unitLeakage = ( hlevelGating == 0 )? hRoot->leakage : hObjectVector[hlevelGating-1]->leakage;
+    double ungatedLeakage = chipLeakage - numGatingUnit * unitLeakage; // DE/BU/IC above the gated units
+
+    // units touched by each layer
+    // (records of the subObjects come before the record of their parent object, so the units found under
+    //  the subObjects are collected in activeUnit[hlevel of subObject] and moved to the parent with its index)
+    vector<set<long long>> layerActiveUnit;
+    vector<set<long long>> activeUnit(hlevelTop+1);
+    int layerIdx = -1;
+    for ( int infoIdx=0; infoIdx < networkInfoRead.Size(); infoIdx++ ) {
+        const InfoRead &infoRead = networkInfoRead.header[infoIdx];
+        if ( infoRead.layerIdx != layerIdx ) {
+            layerActiveUnit.push_back(set<long long>());
+            for ( auto &unit : activeUnit ) { unit.clear(); }
+            layerIdx = infoRead.layerIdx;
+        }
+        int hlevel = infoRead.hlevel;
+        if ( (infoRead.type == INFOREAD_IC) || (hlevel < hlevelGating) ) { continue; }
+
+        set<long long> unit;
+        if ( hlevel == hlevelGating ) {
+            unit.insert(0);
+        } else {
+            unit.swap(activeUnit[hlevel-1]);
+        }
+        if ( hlevel == hlevelTop ) {
+            layerActiveUnit.back().insert(unit.begin(), unit.end());
+        } else {
+            long long idxObject = (long long)infoRead.idxRow * hObjectVector[hlevel]->numSubObjectCol + infoRead.idxCol;
+            for ( auto idxUnit : unit ) {
+                activeUnit[hlevel].insert(idxObject * unitPerObject[hlevel] + idxUnit);
+            }
+        }
+    }
+
+    // leakage energy (W x cycle) of an image
+    double leakageEnergy = 0, totalLatency = 0;
+    numActiveUnit = 0;
+    if ( param->pipeline ) { // every stage is busy in steady state -> units of any layer are active
+        set<long long> unit;
+        for ( auto &layerUnit : layerActiveUnit ) { unit.insert(layerUnit.begin(), layerUnit.end()); }
+        numActiveUnit = unit.size();
+        leakageEnergy = ungatedLeakage + numActiveUnit * unitLeakage;
+        totalLatency = 1;
+    } else { // units woken up for a layer pay the wake-up overhead (images run back to back)
+        int numLayerActive = layerActiveUnit.size();
+        for ( int l=0; l < numLayerActive; l++ ) {
+            const set<long long> &prevUnit = layerActiveUnit[(l + numLayerActive - 1) % numLayerActive];
+            double numWakeUp = 0;
+            for ( auto idxUnit : layerActiveUnit[l] ) { numWakeUp += prevUnit.count(idxUnit)? 0 : 1; }
+            double layerLatency = (*networkLatencyVector)[l][0];
+            leakageEnergy += (ungatedLeakage + layerActiveUnit[l].size() * unitLeakage) * layerLatency +
+                            numWakeUp * unitLeakage * param->powerGatingWakeUp;
+            totalLatency += layerLatency;
+            numActiveUnit += layerActiveUnit[l].size() * layerLatency;
+        }
+        numActiveUnit /= totalLatency;
+    }
+
+    printf("power gating (level %d): active units %.1f / %lld\n", hlevelGating, numActiveUnit, numGatingUnit);
+
+    return leakageEnergy / totalLatency; // average leakage power
+}
@@ -0,0 +1,40 @@
+#include <algorithm>
+#include "ParetoFront.h"
+
+/* a dominates b: no worse in every objective & better in one */
+static bool Dominates(const ParetoPoint &a, const ParetoPoint &b) {
+    return (a.area <= b.area) && (a.energy <= b.energy) && (a.latency <= b.latency)
+           && ((a.area < b.area) || (a.energy < b.energy) || (a.latency < b.latency));
+}
+
+static bool CompareArea(const ParetoPoint &a, const ParetoPoint &b) {
+    return a.area < b.area;
+}
+
+bool ParetoFront::IsDominated(const ParetoPoint &point) const {
+    // points of the front with area <= point.area
+    for ( auto it = pointVector.begin(); (it != pointVector.end()) && (it->area <= point.area); it++ ) {
+        if ( Dominates(*it, point) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParetoFront::Insert(const ParetoPoint &point, vector<int> *removedIds) {
+    if ( IsDominated(point) ) {
+        return false;
+    }
+    // points with area >= point.area can be dominated by the new point
+    auto first = lower_bound(pointVector.begin(), pointVector.end(), point, CompareArea);
+    auto last = remove_if(first, pointVector.end(), [&](const ParetoPoint &p) {
+        if ( Dominates(point, p) ) {
+            if ( removedIds != NULL ) { removedIds->push_back(p.id); }
+            return true;
+        }
+        return false;
+    });
+    pointVector.erase(last, pointVector.end());
+    pointVector.insert(upper_bound(pointVector.begin(), pointVector.end(), point, CompareArea), point);
+    return true;
+}
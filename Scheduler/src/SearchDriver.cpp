@@ -0,0 +1,424 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <set>
+#include "SearchDriver.h"
+#include "GaussianProcess.h"
+
+#define SURROGATE_POOL      10      // candidates screened by the surrogate per offspring
+#define SURROGATE_MAX_DATA  256     // evaluated designs the surrogate is fitted to (the latest ones)
+
+SearchDriver::SearchDriver(DesignSpace *_designSpace, BatchEngine *_batchEngine):
+                           designSpace(_designSpace), batchEngine(_batchEngine) {
+    rng.seed(designSpace->searchSeed);
+    numVariable = 0;
+}
+
+void SearchDriver::InitializeGene() {
+    optionVector.clear();
+    vector<int> arrayOption;
+    for ( int arrayIdx=0; arrayIdx < designSpace->arrayParamVector.size(); arrayIdx++ ) {
+        arrayOption.push_back(arrayIdx);
+    }
+    optionVector.push_back(arrayOption);
+    vector<int> levelOption;
+    for ( int numHierarchy=1; numHierarchy <= designSpace->maxNumHierarchy; numHierarchy++ ) {
+        levelOption.push_back(numHierarchy);
+    }
+    optionVector.push_back(levelOption);
+
+    // IC & BU knobs (fixed to the IC & BU params of the hierarchy unless a list is given)
+    for ( int h=0; h < designSpace->maxNumHierarchy; h++ ) {
+        bool top = ( h == designSpace->maxNumHierarchy-1 );
+        const vector<int> &designParamICBU = top? designSpace->designParamICBUTop : designSpace->designParamICBU;
+        if ( !top ) {
+            optionVector.push_back(designSpace->numSubObjectRowList);
+            optionVector.push_back(designSpace->numSubObjectColList);
+        }
+        optionVector.push_back(designSpace->outTypeList.empty()? vector<int>{designParamICBU[0]} : designSpace->outTypeList);
+        optionVector.push_back(designSpace->inTypeList.empty()? vector<int>{designParamICBU[2]} : designSpace->inTypeList);
+        optionVector.push_back(designSpace->busWidthList.empty()? vector<int>{designParamICBU[1]} : designSpace->busWidthList);
+        optionVector.push_back(designSpace->buTypeList.empty()? vector<int>{designParamICBU[4]} : designSpace->buTypeList);
+        optionVector.push_back(designSpace->coreBWList.empty()? vector<int>{designParamICBU[5]} : designSpace->coreBWList);
+    }
+
+    numVariable = 0;
+    for ( auto &option : optionVector ) {
+        if ( option.size() > 1 ) {
+            numVariable++;
+        }
+    }
+}
+
+vector<int> SearchDriver::RandomGene() {
+    vector<int> gene;
+    for ( auto &option : optionVector ) {
+        gene.push_back(uniform_int_distribution<int>(0, option.size()-1)(rng));
+    }
+    Canonicalize(&gene);
+    return gene;
+}
+
+void SearchDriver::Canonicalize(vector<int> *gene) const {
+    int numHierarchy = optionVector[1][(*gene)[1]];
+    for ( int h=numHierarchy-1; h < designSpace->maxNumHierarchy-1; h++ ) {
+        for ( int knobIdx=0; knobIdx < NUM_KNOB_HOBJ; knobIdx++ ) {
+            (*gene)[2 + h*NUM_KNOB_HOBJ + knobIdx] = 0;
+        }
+    }
+}
+
+bool SearchDriver::IsValid(const vector<int> &gene) const {
+    int numHierarchy = optionVector[1][gene[1]];
+    for ( int h=0; h < numHierarchy-1; h++ ) {
+        int knobIdx = 2 + h*NUM_KNOB_HOBJ;
+        if ( (optionVector[knobIdx][gene[knobIdx]] == 1) && (optionVector[knobIdx+1][gene[knobIdx+1]] == 1) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<vector<int>> SearchDriver::Decode(const vector<int> &gene, int *arrayIdx) const {
+    *arrayIdx = optionVector[0][gene[0]];
+    int numHierarchy = optionVector[1][gene[1]];
+
+    vector<vector<int>> designParam;
+    for ( int h=0; h < numHierarchy; h++ ) {
+        bool top = ( h == numHierarchy-1 );
+        int knobIdx = top? 2 + (designSpace->maxNumHierarchy-1)*NUM_KNOB_HOBJ : 2 + h*NUM_KNOB_HOBJ;
+        vector<int> designParamHObj;
+        if ( top ) {
+            designParamHObj = {10000, 10000};   // tuned by the mapper
+        } else {
+            designParamHObj = {optionVector[knobIdx][gene[knobIdx]], optionVector[knobIdx+1][gene[knobIdx+1]]};
+            knobIdx += 2;
+        }
+        // outType, outBW, inType, inBW, buType, outCoreBW, inCoreBW
+        vector<int> designParamICBU = top? designSpace->designParamICBUTop : designSpace->designParamICBU;
+        designParamICBU[0] = optionVector[knobIdx][gene[knobIdx]];
+        designParamICBU[2] = optionVector[knobIdx+1][gene[knobIdx+1]];
+        if ( !designSpace->busWidthList.empty() ) {
+            designParamICBU[1] = designParamICBU[3] = optionVector[knobIdx+2][gene[knobIdx+2]];
+        }
+        designParamICBU[4] = optionVector[knobIdx+3][gene[knobIdx+3]];
+        designParamICBU[5] = optionVector[knobIdx+4][gene[knobIdx+4]];
+        designParamHObj.insert(designParamHObj.end(), designParamICBU.begin(), designParamICBU.end());
+        designParam.push_back(designParamHObj);
+    }
+    return designParam;
+}
+
+int SearchDriver::Propose(const vector<int> &gene) {
+    int arrayIdx;
+    vector<vector<int>> designParam = Decode(gene, &arrayIdx);
+    int designIdx = designSpace->AddDesign(arrayIdx, designParam);
+    archive[gene] = designIdx;
+    geneVector.push_back(gene);
+
+    // design params of every proposed design (breakdowns are only saved for the Pareto front)
+    ofstream fout(batchEngine->basefolder + "/proposals.csv", ios::app);
+    if ( designIdx == 0 ) {
+        fout << "archIdx,arrayIdx,numHierarchy,designParam\n";
+    }
+    fout << designIdx << "," << arrayIdx << "," << designParam.size() << ",";
+    for ( int h=0; h < designParam.size(); h++ ) {
+        for ( int i=0; i < designParam[h].size(); i++ ) {
+            fout << (( (h == 0) && (i == 0) )? "" : " ") << designParam[h][i];
+        }
+    }
+    fout << "\n";
+    return designIdx;
+}
+
+/* a dominates b: no worse in every objective & better in one */
+static bool Dominates(const DesignResult &a, const DesignResult &b) {
+    return (a.area <= b.area) && (a.energy <= b.energy) && (a.latency <= b.latency)
+           && ((a.area < b.area) || (a.energy < b.energy) || (a.latency < b.latency));
+}
+
+void SearchDriver::Sort(const vector<int> &designIdxVector, map<int, int> *rank, map<int, double> *crowding) const {
+    const map<int, DesignResult> &resultMap = batchEngine->resultMap;
+    vector<int> feasibleVector, infeasibleVector;
+    for ( auto designIdx : designIdxVector ) {
+        if ( resultMap.at(designIdx).status == DESIGN_EVALUATED ) {
+            feasibleVector.push_back(designIdx);
+        } else {
+            infeasibleVector.push_back(designIdx);
+        }
+    }
+
+    // fast non-dominated sort of the feasible designs
+    int numFeasible = feasibleVector.size();
+    vector<vector<int>> dominatedVector(numFeasible);
+    vector<int> numDominating(numFeasible, 0);
+    vector<vector<int>> frontVector(1);
+    for ( int i=0; i < numFeasible; i++ ) {
+        const DesignResult &result = resultMap.at(feasibleVector[i]);
+        for ( int j=0; j < numFeasible; j++ ) {
+            if ( Dominates(result, resultMap.at(feasibleVector[j])) ) {
+                dominatedVector[i].push_back(j);
+            } else if ( Dominates(resultMap.at(feasibleVector[j]), result) ) {
+                numDominating[i]++;
+            }
+        }
+        if ( numDominating[i] == 0 ) {
+            frontVector[0].push_back(i);
+        }
+    }
+    while ( !frontVector.back().empty() ) {
+        vector<int> nextFront;
+        for ( auto i : frontVector.back() ) {
+            for ( auto j : dominatedVector[i] ) {
+                if ( --numDominating[j] == 0 ) {
+                    nextFront.push_back(j);
+                }
+            }
+        }
+        frontVector.push_back(nextFront);
+    }
+    frontVector.pop_back();
+    for ( auto &front : frontVector ) {
+        for ( auto &i : front ) {
+            i = feasibleVector[i];
+        }
+    }
+    // designs violating a constraint (or pruned/failed) are behind every feasible design
+    if ( !infeasibleVector.empty() ) {
+        frontVector.push_back(infeasibleVector);
+    }
+
+    // crowding distance in the objectives (boundary designs are kept)
+    for ( int frontIdx=0; frontIdx < frontVector.size(); frontIdx++ ) {
+        vector<int> &front = frontVector[frontIdx];
+        sort(front.begin(), front.end());
+        for ( auto designIdx : front ) {
+            (*rank)[designIdx] = frontIdx;
+            (*crowding)[designIdx] = 0;
+        }
+        if ( resultMap.at(front[0]).status != DESIGN_EVALUATED ) {
+            continue;
+        }
+        for ( int objective=0; objective < 3; objective++ ) {
+            auto metric = [&](int designIdx) {
+                const DesignResult &result = resultMap.at(designIdx);
+                return ( objective == 0 )? result.area : ( objective == 1 )? result.energy : result.latency;
+            };
+            vector<int> sortedFront = front;
+            stable_sort(sortedFront.begin(), sortedFront.end(), [&](int a, int b) { return metric(a) < metric(b); });
+            double range = metric(sortedFront.back()) - metric(sortedFront.front());
+            (*crowding)[sortedFront.front()] = numeric_limits<double>::infinity();
+            (*crowding)[sortedFront.back()] = numeric_limits<double>::infinity();
+            for ( int i=1; (i < (int)sortedFront.size()-1) && (range > 0); i++ ) {
+                (*crowding)[sortedFront[i]] += (metric(sortedFront[i+1]) - metric(sortedFront[i-1])) / range;
+            }
+        }
+    }
+}
+
+vector<int> SearchDriver::Select(const vector<int> &designIdxVector, int numSelect) const {
+    map<int, int> rank;
+    map<int, double> crowding;
+    Sort(designIdxVector, &rank, &crowding);
+    vector<int> sortedVector = designIdxVector;
+    sort(sortedVector.begin(), sortedVector.end(), [&](int a, int b) {
+        if ( rank[a] != rank[b] ) { return rank[a] < rank[b]; }
+        if ( crowding[a] != crowding[b] ) { return crowding[a] > crowding[b]; }
+        return a < b;
+    });
+    if ( sortedVector.size() > numSelect ) {
+        sortedVector.resize(numSelect);
+    }
+    return sortedVector;
+}
+
+vector<int> SearchDriver::MakeOffspring(const vector<int> &population) {
+    map<int, int> rank;
+    map<int, double> crowding;
+    Sort(population, &rank, &crowding);
+    uniform_int_distribution<int> pick(0, population.size()-1);
+    uniform_real_distribution<double> uniform(0, 1);
+    auto tournament = [&]() {
+        int a = population[pick(rng)];
+        int b = population[pick(rng)];
+        if ( rank[a] != rank[b] ) { return ( rank[a] < rank[b] )? a : b; }
+        return ( crowding[a] >= crowding[b] )? a : b;
+    };
+
+    int numOffspring = designSpace->searchPopulation;
+    int numCandidate = designSpace->searchSurrogate? numOffspring * SURROGATE_POOL : numOffspring;
+    vector<vector<int>> candidateVector;
+    set<vector<int>> candidateSet;
+    for ( int trial=0; (candidateVector.size() < numCandidate) && (trial < 100*numCandidate); trial++ ) {
+        vector<int> gene = geneVector[tournament()];
+        const vector<int> &mate = geneVector[tournament()];
+        // uniform crossover
+        if ( uniform(rng) < 0.9 ) {
+            for ( int i=0; i < gene.size(); i++ ) {
+                if ( uniform(rng) < 0.5 ) {
+                    gene[i] = mate[i];
+                }
+            }
+        }
+        // mutation (another option of the knob)
+        for ( int i=0; i < gene.size(); i++ ) {
+            int numOption = optionVector[i].size();
+            if ( (numOption > 1) && (uniform(rng) < 1.0/numVariable) ) {
+                gene[i] = (gene[i] + uniform_int_distribution<int>(1, numOption-1)(rng)) % numOption;
+            }
+        }
+        Canonicalize(&gene);
+        // designs are evaluated once
+        if ( !IsValid(gene) || archive.count(gene) || candidateSet.count(gene) ) {
+            continue;
+        }
+        candidateSet.insert(gene);
+        candidateVector.push_back(gene);
+    }
+    if ( designSpace->searchSurrogate ) {
+        candidateVector = Screen(candidateVector, numOffspring);
+    }
+
+    vector<int> offspring;
+    for ( auto &gene : candidateVector ) {
+        offspring.push_back(Propose(gene));
+    }
+    return offspring;
+}
+
+/* candidates whose optimistic (lower confidence bound) metrics improve the Pareto front the most:
+ * additive epsilon (log scale) by which the candidate is not dominated by any design of the front */
+vector<vector<int>> SearchDriver::Screen(const vector<vector<int>> &candidateVector, int numSelect) const {
+    if ( candidateVector.size() <= numSelect ) {
+        return candidateVector;
+    }
+    vector<vector<double>> inputVector, targetVector;
+    const map<int, DesignResult> &resultMap = batchEngine->resultMap;
+    for ( auto it = resultMap.rbegin(); (it != resultMap.rend()) && (inputVector.size() < SURROGATE_MAX_DATA); it++ ) {
+        const DesignResult &result = it->second;
+        if ( (result.designIdx < geneVector.size()) && (result.status == DESIGN_EVALUATED) ) {
+            inputVector.push_back(Normalize(geneVector[result.designIdx]));
+            targetVector.push_back({log(result.area), log(result.energy), log(result.latency)});
+        }
+    }
+    if ( inputVector.size() < 4 ) {
+        return vector<vector<int>>(candidateVector.begin(), candidateVector.begin() + numSelect);
+    }
+    GaussianProcess gaussianProcess(0.25*sqrt((double)numVariable), 1e-4);
+    gaussianProcess.Fit(inputVector, targetVector);
+
+    ParetoFront paretoFront;
+    GetFront(&paretoFront);
+    vector<double> scoreVector;
+    for ( auto &gene : candidateVector ) {
+        vector<double> mean, std;
+        gaussianProcess.Predict(Normalize(gene), &mean, &std);
+        double score = numeric_limits<double>::infinity();
+        for ( auto &point : paretoFront.pointVector ) {
+            vector<double> frontMetric = {log(point.area), log(point.energy), log(point.latency)};
+            double margin = -numeric_limits<double>::infinity();
+            for ( int k=0; k < 3; k++ ) {
+                margin = max(margin, frontMetric[k] - (mean[k] - std[k]));
+            }
+            score = min(score, margin);
+        }
+        scoreVector.push_back(score);
+    }
+    vector<int> orderVector;
+    for ( int i=0; i < candidateVector.size(); i++ ) {
+        orderVector.push_back(i);
+    }
+    stable_sort(orderVector.begin(), orderVector.end(), [&](int a, int b) { return scoreVector[a] > scoreVector[b]; });
+    vector<vector<int>> selectedVector;
+    for ( int i=0; i < numSelect; i++ ) {
+        selectedVector.push_back(candidateVector[orderVector[i]]);
+    }
+    return selectedVector;
+}
+
+vector<double> SearchDriver::Normalize(const vector<int> &gene) const {
+    vector<double> input;
+    for ( int i=0; i < gene.size(); i++ ) {
+        if ( optionVector[i].size() > 1 ) {
+            input.push_back((double)gene[i] / (optionVector[i].size()-1));
+        }
+    }
+    return input;
+}
+
+void SearchDriver::GetFront(ParetoFront *paretoFront) const {
+    paretoFront->Clear();
+    for ( int designIdx=0; designIdx < geneVector.size(); designIdx++ ) {
+        const DesignResult &result = batchEngine->resultMap.at(designIdx);
+        if ( result.status == DESIGN_EVALUATED ) {
+            vector<int> removedIds;
+            paretoFront->Insert({designIdx, result.area, result.energy, result.latency}, &removedIds);
+        }
+    }
+}
+
+void SearchDriver::SaveProgress(int generation, const vector<int> &population) const {
+    map<int, int> rank;
+    map<int, double> crowding;
+    Sort(population, &rank, &crowding);
+    int numFirstFront = 0;
+    for ( auto designIdx : population ) {
+        if ( (rank[designIdx] == 0) && (batchEngine->resultMap.at(designIdx).status == DESIGN_EVALUATED) ) {
+            numFirstFront++;
+        }
+    }
+    vector<int> numStatus(5, 0);
+    for ( int designIdx=0; designIdx < geneVector.size(); designIdx++ ) {
+        numStatus[batchEngine->resultMap.at(designIdx).status]++;
+    }
+    ParetoFront paretoFront;
+    GetFront(&paretoFront);
+    printf("---------- Search: generation %d, %d designs, %d Pareto designs (%d in the population) ----------\n",
+           generation, (int)geneVector.size(), paretoFront.Size(), numFirstFront);
+
+    string filename = batchEngine->basefolder + "/search.csv";
+    ofstream fout(filename, ios::app);
+    if ( generation == 0 ) {
+        fout << "generation,numDesigns,numEvaluated,numInfeasible,numPruned,numFailed,numDuplicate,numPareto\n";
+    }
+    fout << generation << "," << geneVector.size() << "," << numStatus[DESIGN_EVALUATED] << "," << numStatus[DESIGN_INFEASIBLE] << ","
+         << numStatus[DESIGN_PRUNED] << "," << numStatus[DESIGN_FAILED] << "," << numStatus[DESIGN_DUPLICATE] << ","
+         << paretoFront.Size() << "\n";
+}
+
+void SearchDriver::Run() {
+    InitializeGene();
+    int numPopulation = designSpace->searchPopulation;
+    printf("---------- Search: NSGA-II%s, %d designs x %d generations over %d knobs ----------\n",
+           designSpace->searchSurrogate? " (surrogate)" : "", numPopulation, designSpace->searchGeneration, numVariable);
+    // proposals are replayed from the seed (designs of the journal are not evaluated again)
+    remove((batchEngine->basefolder + "/search.csv").c_str());
+    remove((batchEngine->basefolder + "/proposals.csv").c_str());
+    batchEngine->Start();
+
+    // initial population
+    vector<int> population;
+    for ( int trial=0; (population.size() < numPopulation) && (trial < 100*numPopulation); trial++ ) {
+        vector<int> gene = RandomGene();
+        if ( IsValid(gene) && (archive.count(gene) == 0) ) {
+            population.push_back(Propose(gene));
+        }
+    }
+    batchEngine->EvaluateBatch(population);
+    SaveProgress(0, population);
+
+    for ( int generation=1; generation <= designSpace->searchGeneration; generation++ ) {
+        vector<int> offspring = MakeOffspring(population);
+        if ( offspring.empty() ) {
+            printf("---------- Search: no new design from the population ----------\n");
+            break;
+        }
+        batchEngine->EvaluateBatch(offspring);
+        population.insert(population.end(), offspring.begin(), offspring.end());
+        population = Select(population, numPopulation);
+        SaveProgress(generation, population);
+    }
+    batchEngine->Finish();
+}
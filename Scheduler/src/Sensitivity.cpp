@@ -0,0 +1,243 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include "Sensitivity.h"
+#include "Param.h"
+#include "DesignError.h"
+#include "formula.h"
+
+extern Param *param;
+
+#define IDX_DELAYTOL    10      // delaytolerance in a designArch row
+
+Sensitivity::Sensitivity(SimServer *_simServer): simServer(_simServer) {
+    step = 0.1;
+    verify = false;
+}
+
+void Sensitivity::Initialize(const string &_networkList, const vector<vector<int>> &_designParam, int _scheduler_type,
+                             double _step, bool _verify) {
+    networkList = _networkList;
+    designParam = _designParam;
+    scheduler_type = _scheduler_type;
+    step = _step;
+    verify = _verify;
+    knobVector.clear();
+    resultVector.clear();
+    numEvaluated = numScheduleReused = numUnchanged = numInfeasible = 0;
+    numBuiltObject = numSharedObject = 0;
+    baseTime = perturbTime = 0;
+}
+
+static vector<vector<double>> toDoubleVector2(const vector<vector<int>> &values) {
+    vector<vector<double>> doubleValues;
+    for ( auto &row : values ) {
+        doubleValues.push_back(vector<double>(row.begin(), row.end()));
+    }
+    return doubleValues;
+}
+
+void Sensitivity::InitializeKnob() {
+    knobVector.clear();
+
+    /* design params of each hierarchy (numSubObject of the top is sized by the generator, 0 is a mode: no input buffer core) */
+    const char *designParamName[] = {"numSubObjectRow", "numSubObjectCol", "", "outBW", "", "inBW", "", "outCoreBW", "inCoreBW"};
+    int numHierarchy = designParam.size();
+    for ( int h=0; h < numHierarchy; h++ ) {
+        for ( int idx : {0, 1, 3, 5, 7, 8} ) {
+            if ( ((idx < 2) && (h == numHierarchy-1)) || (designParam[h][idx] == 0) ) {
+                continue;
+            }
+            knobVector.push_back({designParamName[idx], KNOB_DESIGNPARAM, h+1, idx, true, (double)designParam[h][idx]});
+        }
+        knobVector.push_back({"delaytolerance", KNOB_DELAYTOL, h+1, IDX_DELAYTOL, false, baseDesignArch[h][IDX_DELAYTOL]});
+    }
+
+    /* Param */
+    knobVector.push_back({"clkFreq", KNOB_CLKFREQ, 0, -1, false, simServer->clkFreq});
+    const char *arrayParamName[] = {"numRowCIMArray", "numColCIMArray", "levelOutput", "numColMuxed"};
+    for ( int idx=0; idx < simServer->arrayParam.size(); idx++ ) {
+        knobVector.push_back({arrayParamName[idx], KNOB_ARRAY, 0, idx, true, (double)simServer->arrayParam[idx]});
+    }
+}
+
+double Sensitivity::Perturb(const SensitivityKnob &knob, int sign) const {
+    if ( knob.baseValue == 0 ) {
+        return sign * step;
+    }
+    double delta = knob.baseValue * step;
+    if ( knob.integer ) {
+        delta = MAX(1, round(delta));
+    }
+    return knob.baseValue + sign * delta;
+}
+
+ServerResult Sensitivity::Evaluate(const SensitivityKnob &knob, double value, bool reuse, bool *scheduleReused, bool *unchanged) {
+    vector<int> arrayParam = simServer->arrayParam;
+    vector<vector<int>> tmpDesignParam = designParam;
+    double clkFreq = simServer->clkFreq;
+    if ( knob.type == KNOB_DESIGNPARAM ) {
+        tmpDesignParam[knob.hlevel-1][knob.idx] = (int)value;
+    } else if ( knob.type == KNOB_ARRAY ) {
+        arrayParam[knob.idx] = (int)value;
+    } else if ( knob.type == KNOB_CLKFREQ ) {
+        simServer->clkFreq = value;     // clkFreq of the root (part of its key)
+    }
+
+    // the generator & scheduler read neither clkFreq nor delaytolerance (the replicas are balanced on the latency)
+    bool sameStructure = ( knob.type == KNOB_DELAYTOL ) || ( knob.type == KNOB_CLKFREQ );
+    *scheduleReused = reuse && sameStructure && ( param->replicaBudget == 0 );
+    *unchanged = false;
+
+    ServerResult result;
+    try {
+        HierarchyRoot *hRoot;
+        string rootKey;
+        bool rootHit;
+        const ServerNetwork &network = simServer->Prepare(networkList, simServer->synapseBit, simServer->numBitInput, arrayParam,
+                                                          &hRoot, &rootKey, &rootHit);
+        vector<vector<double>> designArch = baseDesignArch;
+        if ( !(reuse && sameStructure) ) {
+            simServer->archGenerator.Initialize(hRoot, network.networkStructureVector, scheduler_type);
+            designArch = toDoubleVector2(simServer->archGenerator.Generate(tmpDesignParam));
+        }
+        if ( knob.type == KNOB_DELAYTOL ) {
+            designArch[knob.hlevel-1][IDX_DELAYTOL] = value;
+        }
+
+        // a design param the generated design does not depend on (e.g. coreBW without BU cores)
+        if ( reuse && (knob.type == KNOB_DESIGNPARAM) && (designArch == baseDesignArch) ) {
+            *unchanged = true;
+            result = baseResult;
+        } else {
+            result = simServer->EvaluateArch(network, hRoot, rootKey, designArch, scheduler_type, reuse,
+                                             (*scheduleReused)? &baseEvaluator : NULL, NULL);
+        }
+    } catch ( ... ) {
+        simServer->clkFreq = clkFreq;
+        throw;
+    }
+    simServer->clkFreq = clkFreq;
+    return result;
+}
+
+static double relativeError(double value, double baseValue) {
+    return fabs(value - baseValue) / fabs(baseValue);
+}
+
+void Sensitivity::Run() {
+
+    /* Base design (kept in the subtree cache, with its schedule) */
+    auto start = chrono::high_resolution_clock::now();
+    HierarchyRoot *hRoot;
+    string rootKey;
+    bool rootHit;
+    const ServerNetwork &network = simServer->Prepare(networkList, simServer->synapseBit, simServer->numBitInput,
+                                                      simServer->arrayParam, &hRoot, &rootKey, &rootHit);
+    simServer->archGenerator.Initialize(hRoot, network.networkStructureVector, scheduler_type);
+    baseDesignArch = toDoubleVector2(simServer->archGenerator.Generate(designParam));
+    baseResult = simServer->EvaluateArch(network, hRoot, rootKey, baseDesignArch, scheduler_type, true, NULL, &baseEvaluator);
+    baseTime = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    printf("---------- Sensitivity: base design %.4e m^2 %.4e J %.4e s ----------\n",
+           baseResult.area, baseResult.energy, baseResult.latency);
+
+    InitializeKnob();
+    int tmpNumBuiltObject = simServer->numBuiltObject;
+    int tmpNumSharedObject = simServer->numSharedObject;
+
+    /* Forward difference of each knob (backward if the forward design is infeasible) */
+    for ( auto &knob : knobVector ) {
+        SensitivityResult sResult;
+        sResult.knob = knob;
+        sResult.value = knob.baseValue;
+        sResult.status = "infeasible";
+        sResult.absolute = ( knob.baseValue == 0 );
+        sResult.scheduleReused = false;
+        sResult.verifyError = -1;
+        bool unchanged = false;
+        for ( int sign : {1, -1} ) {
+            double value = Perturb(knob, sign);
+            if ( (value < 0) || ((value == 0) && (knob.type != KNOB_DELAYTOL)) ) {
+                continue;
+            }
+            sResult.value = value;
+            try {
+                start = chrono::high_resolution_clock::now();
+                sResult.result = Evaluate(knob, value, true, &sResult.scheduleReused, &unchanged);
+                perturbTime += chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+                sResult.status = unchanged? "unchanged" : "ok";
+                sResult.reason = "";
+                break;
+            } catch ( const DesignError &e ) {
+                sResult.reason = e.reason;
+            }
+        }
+
+        if ( sResult.status == "infeasible" ) {
+            numInfeasible++;
+            sResult.dArea = sResult.dEnergy = sResult.dLatency = 0;
+        } else {
+            numEvaluated += unchanged? 0 : 1;
+            numUnchanged += unchanged? 1 : 0;
+            numScheduleReused += sResult.scheduleReused? 1 : 0;
+            // (dM/M) / (dx/x), or (dM/M) / dx for a knob of base value 0
+            double dx = sResult.absolute? (sResult.value - knob.baseValue) : (sResult.value - knob.baseValue) / knob.baseValue;
+            sResult.dArea = (sResult.result.area - baseResult.area) / baseResult.area / dx;
+            sResult.dEnergy = (sResult.result.energy - baseResult.energy) / baseResult.energy / dx;
+            sResult.dLatency = (sResult.result.latency - baseResult.latency) / baseResult.latency / dx;
+
+            if ( verify ) {
+                bool tmpScheduleReused, tmpUnchanged;
+                ServerResult fullResult = Evaluate(knob, sResult.value, false, &tmpScheduleReused, &tmpUnchanged);
+                sResult.verifyError = MAX(relativeError(sResult.result.area, fullResult.area),
+                                          MAX(relativeError(sResult.result.energy, fullResult.energy),
+                                              relativeError(sResult.result.latency, fullResult.latency)));
+            }
+        }
+        printf("%-16s hlevel %d: %g -> %g  dArea %+.4f dEnergy %+.4f dLatency %+.4f  (%s%s%s)\n",
+               knob.name.c_str(), knob.hlevel, knob.baseValue, sResult.value, sResult.dArea, sResult.dEnergy, sResult.dLatency,
+               sResult.status.c_str(), sResult.reason.empty()? "" : ", ", sResult.reason.c_str());
+        resultVector.push_back(sResult);
+    }
+    numBuiltObject = simServer->numBuiltObject - tmpNumBuiltObject;
+    numSharedObject = simServer->numSharedObject - tmpNumSharedObject;
+    if ( verify ) {
+        // the evaluations from scratch are not counted
+        numBuiltObject -= (numEvaluated + numUnchanged) * baseDesignArch.size();
+    }
+
+    printf("---------- Sensitivity: %d knobs, %d evaluated (%d schedules reused), %d unchanged, %d infeasible ----------\n",
+           (int)knobVector.size(), numEvaluated, numScheduleReused, numUnchanged, numInfeasible);
+    printf("---------- Sensitivity: hierarchy objects built %d, shared %d; base design %.3f s, perturbations %.3f s ----------\n",
+           numBuiltObject, numSharedObject, baseTime, perturbTime);
+}
+
+/* normalized partial derivatives of each knob (metrics in the units of the main_iter metric files) */
+void Sensitivity::Save(const string &filename) const {
+    ofstream fout(filename);
+    fout.precision(10);
+    fout << "knob,hlevel,baseValue,value,status,reason,area,energy_with_leakage,latency,"
+         << "dArea,dEnergy,dLatency,normalization,numShared,scheduleReused,verifyError\n";
+    fout << "base,,,,ok,," << baseResult.area*1e12 << "," << baseResult.energy*1e12 << "," << baseResult.latency*1e12
+         << ",,,,," << baseResult.numShared << ",,\n";
+    for ( auto &sResult : resultVector ) {
+        const SensitivityKnob &knob = sResult.knob;
+        fout << knob.name << "," << knob.hlevel << "," << knob.baseValue << "," << sResult.value << ","
+             << sResult.status << "," << sResult.reason << ",";
+        if ( sResult.status == "infeasible" ) {
+            fout << ",,,,,,,,,\n";
+            continue;
+        }
+        const ServerResult &result = sResult.result;
+        fout << result.area*1e12 << "," << result.energy*1e12 << "," << result.latency*1e12 << ","
+             << sResult.dArea << "," << sResult.dEnergy << "," << sResult.dLatency << ","
+             << (sResult.absolute? "absolute" : "relative") << "," << result.numShared << ","
+             << sResult.scheduleReused << ",";
+        if ( sResult.verifyError >= 0 ) {
+            fout << sResult.verifyError;
+        }
+        fout << "\n";
+    }
+}
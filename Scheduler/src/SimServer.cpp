@@ -0,0 +1,436 @@
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include "SimServer.h"
+#include "Evaluator.h"
+#include "Param.h"
+#include "DesignError.h"
+#include "formula.h"
+#include "util.h"
+
+extern Param *param;
+
+SimServer::SimServer(InputParameter& _inputParameter, Technology& _tech, MemCell& _cell):
+                    inputParameter(_inputParameter), tech(_tech), cell(_cell),
+                    archGenerator(_inputParameter, _tech, _cell) {
+    maxCachedDesign = 64;
+    shutdown = false;
+}
+
+void SimServer::Initialize(int _synapseBit, int _numBitInput, int _scheduler_type) {
+    synapseBit = _synapseBit;
+    numBitInput = _numBitInput;
+    scheduler_type = _scheduler_type;
+    cellBit = param->cellBit;
+    clkFreq = param->clkFreq;
+    arrayParam = {param->numRowCIMArray, param->numColCIMArray, param->levelOutput, param->numColMuxed};
+
+    numRequest = numEvaluated = numResultHit = numRootHit = numRootMiss = 0;
+    numSharedObject = numBuiltObject = numError = 0;
+}
+
+static string joinKey(const vector<int> &values) {
+    string key;
+    for ( int i=0; i < values.size(); i++ ) {
+        key += ( i == 0 )? to_string(values[i]) : " " + to_string(values[i]);
+    }
+    return key;
+}
+
+// root & designArch of hlevel 1 to numLevel (fractional fields, e.g. delaytolerance, kept exact)
+static string getPrefixKey(const string &rootKey, const vector<vector<double>> &designArch, int numLevel) {
+    ostringstream oss;
+    oss.precision(17);
+    oss << rootKey;
+    for ( int h=0; h < numLevel; h++ ) {
+        for ( int i=0; i < designArch[h].size(); i++ ) {
+            oss << (( i == 0 )? ";" : " ") << designArch[h][i];
+        }
+    }
+    return oss.str();
+}
+
+static vector<vector<int>> toIntVector2(const vector<vector<double>> &values) {
+    vector<vector<int>> intValues;
+    for ( auto &row : values ) {
+        intValues.push_back(vector<int>(row.begin(), row.end()));
+    }
+    return intValues;
+}
+
+string SimServer::HandleRequest(const string &line) {
+    numRequest++;
+    JsonValue response = JsonValue::Object();
+    try {
+        JsonValue request = JsonValue::Parse(line);
+        if ( request.type != JSON_OBJECT ) {
+            throw runtime_error("request is not an object");
+        }
+        if ( request.Has("id") ) {
+            response.Set("id", request.Get("id"));
+        }
+        string command = request.Has("command")? request.Get("command").AsString() : "evaluate";
+        if ( command == "evaluate" ) {
+            JsonValue result = Evaluate(request);
+            for ( auto &member : result.object ) {
+                response.Set(member.first, member.second);
+            }
+        } else if ( command == "ping" ) {
+            response.Set("status", "ok");
+        } else if ( command == "stats" ) {
+            response.Set("status", "ok");
+            response.Set("stats", Stats());
+        } else if ( command == "shutdown" ) {
+            response.Set("status", "ok");
+            shutdown = true;
+        } else {
+            throw runtime_error("unknown command " + command);
+        }
+    } catch ( const DesignError &e ) {
+        // invalid design: the reason code of the batch DSE
+        numError++;
+        response.Set("status", "error");
+        response.Set("reason", e.reason);
+        response.Set("message", string(e.what()));
+    } catch ( const exception &e ) {
+        numError++;
+        response.Set("status", "error");
+        response.Set("reason", "badRequest");
+        response.Set("message", string(e.what()));
+    }
+    return response.Dump();
+}
+
+/* evaluate request: {"network": portfolio, "designParam": [[...], ...], "array": [row, col, levelOutput, numColMuxed],
+ *                    "wbits": int, "abits": int, "scheduler_type": int, "cache": bool, "breakdown": bool}
+ * (only network & designParam required, the others default to the arguments of the server) */
+JsonValue SimServer::Evaluate(const JsonValue &request) {
+    string networkList = request.Get("network").AsString();
+    vector<vector<int>> designParam = request.Get("designParam").AsIntVector2();
+    vector<int> requestArray = request.Has("array")? request.Get("array").AsIntVector() : arrayParam;
+    int requestSynapseBit = request.Has("wbits")? request.Get("wbits").AsInt() : synapseBit;
+    int requestNumBitInput = request.Has("abits")? request.Get("abits").AsInt() : numBitInput;
+    int requestScheduler = request.Has("scheduler_type")? request.Get("scheduler_type").AsInt() : scheduler_type;
+    bool cache = request.Has("cache")? request.Get("cache").AsBool() : true;
+    bool breakdown = request.Has("breakdown")? request.Get("breakdown").AsBool() : false;
+
+    if ( designParam.empty() ) {
+        throw runtime_error("designParam has no hierarchy");
+    }
+    for ( auto &designHObj : designParam ) {
+        if ( designHObj.size() != 9 ) {
+            throw runtime_error("designParam rows need 9 values (row, col, outType, outBW, inType, inBW, buType, outCoreBW, inCoreBW)");
+        }
+    }
+    if ( (requestArray.size() != 4) || (requestArray[0] < 1) || (requestArray[1] < 1) || (requestArray[2] < 2)
+         || (requestArray[3] < 1) ) {
+        throw runtime_error("array needs 4 values (numRowCIMArray, numColCIMArray, levelOutput >= 2, numColMuxed)");
+    }
+    if ( (requestSynapseBit < 1) || (requestNumBitInput < 1) ) {
+        throw runtime_error("wbits & abits should be positive");
+    }
+    if ( (requestScheduler != 0) && (requestScheduler != 1) ) {
+        throw runtime_error("scheduler_type should be 0 (base) or 1 (compact mapping)");
+    }
+
+    ServerResult result = EvaluateDesign(networkList, requestSynapseBit, requestNumBitInput, requestScheduler,
+                                         requestArray, designParam, cache);
+
+    JsonValue response = JsonValue::Object();
+    response.Set("status", "ok");
+    response.Set("area", result.area);
+    response.Set("energy", result.energy);
+    response.Set("latency", result.latency);
+    response.Set("power", result.power);
+    response.Set("topsw", result.topsw);
+    response.Set("tops", result.tops);
+    response.Set("clkPeriod", result.clkPeriod);
+    response.Set("designArch", JsonValue(result.designArch));
+    JsonValue networks = JsonValue::Array();
+    for ( int networkIdx=0; networkIdx < result.networkNames.size(); networkIdx++ ) {
+        const vector<double> &metric = result.networkMetric[networkIdx];
+        JsonValue network = JsonValue::Object();
+        network.Set("name", result.networkNames[networkIdx]);
+        network.Set("energy", metric[0]);
+        network.Set("latency", metric[1]);
+        network.Set("topsw", metric[2]);
+        network.Set("tops", metric[3]);
+        networks.Append(network);
+    }
+    response.Set("networks", networks);
+    if ( breakdown ) {
+        JsonValue breakdowns = JsonValue::Object();
+        breakdowns.Set("chipArea", JsonValue(result.chipAreaVector));
+        breakdowns.Set("chipLatency", JsonValue(result.chipLatencyVector));
+        breakdowns.Set("chipEnergy", JsonValue(result.chipEnergyVector));
+        breakdowns.Set("area", JsonValue(result.areaVector2));
+        breakdowns.Set("latency", JsonValue(result.latencyVector2));
+        breakdowns.Set("energy", JsonValue(result.energyVector2));
+        response.Set("breakdown", breakdowns);
+    }
+    JsonValue cacheUsed = JsonValue::Object();
+    cacheUsed.Set("result", result.resultHit);
+    cacheUsed.Set("root", result.rootHit);
+    cacheUsed.Set("shared", result.numShared);
+    response.Set("cache", cacheUsed);
+    return response;
+}
+
+JsonValue SimServer::Stats() const {
+    JsonValue stats = JsonValue::Object();
+    stats.Set("numRequest", numRequest);
+    stats.Set("numEvaluated", numEvaluated);
+    stats.Set("numResultHit", numResultHit);
+    stats.Set("numRootHit", numRootHit);
+    stats.Set("numRootMiss", numRootMiss);
+    stats.Set("numSharedObject", numSharedObject);
+    stats.Set("numBuiltObject", numBuiltObject);
+    stats.Set("numError", numError);
+    stats.Set("numNetwork", (int)networkCache.size());
+    stats.Set("numRoot", (int)rootCache.size());
+    stats.Set("numCachedDesign", (int)subtreeOrder.size());
+    stats.Set("numCachedResult", (int)resultCache.size());
+    return stats;
+}
+
+const ServerNetwork& SimServer::GetNetwork(const string &networkList, int _synapseBit, int _numBitInput) {
+    string networkKey = networkList + "|" + to_string(_synapseBit) + " " + to_string(_numBitInput);
+    auto it = networkCache.find(networkKey);
+    if ( it != networkCache.end() ) {
+        return it->second;
+    }
+
+    // network portfolio (comma-separated network files with optional weights, file[:weight])
+    ServerNetwork network;
+    vector<string> networkFiles;
+    readNetworkList(networkList, &networkFiles, &network.networkWeights);
+    network.synapseBit = 0;
+    network.numBitInput = 0;
+    double totalWeight = 0;
+    for ( int networkIdx=0; networkIdx < networkFiles.size(); networkIdx++ ) {
+        // readCSVint exits on a missing file, the server answers with an error instead
+        if ( !ifstream(networkFiles[networkIdx].c_str()).good() ) {
+            throw runtime_error("network file " + networkFiles[networkIdx] + " cannot be opened");
+        }
+        vector<vector<int>> networkStructure = readCSVint(networkFiles[networkIdx]);
+        int tmpSynapseBit = _synapseBit, tmpNumBitInput = _numBitInput;
+        setLayerPrecision(networkStructure, &tmpSynapseBit, &tmpNumBitInput); // per-layer precision (max for hardware)
+        network.synapseBit = MAX(network.synapseBit, tmpSynapseBit);
+        network.numBitInput = MAX(network.numBitInput, tmpNumBitInput);
+        network.networkStructureVector.push_back(networkStructure);
+        vector<vector<double>> networkStructure_db;
+        for ( auto &layerStructure : networkStructure ) {
+            networkStructure_db.push_back(vector<double>(layerStructure.begin(), layerStructure.end()));
+        }
+        network.networkStructureVector_db.push_back(networkStructure_db);
+        network.networkNames.push_back(getNetworkName(networkFiles[networkIdx]));
+        totalWeight += network.networkWeights[networkIdx];
+    }
+    if ( networkFiles.empty() || (totalWeight <= 0) ) {
+        throw runtime_error("network portfolio " + networkList + " has no weighted network");
+    }
+    for ( auto &weight : network.networkWeights ) {
+        weight /= totalWeight;
+    }
+    return networkCache.insert(make_pair(networkKey, network)).first->second;
+}
+
+HierarchyRoot* SimServer::GetRoot(const string &rootKey, bool *hit) {
+    auto it = rootCache.find(rootKey);
+    *hit = ( it != rootCache.end() );
+    if ( !*hit ) {
+        numRootMiss++;
+        unique_ptr<HierarchyRoot> hRoot(new HierarchyRoot(inputParameter, tech, cell));
+        hRoot->Initialize();
+        it = rootCache.insert(make_pair(rootKey, move(hRoot))).first;
+    } else {
+        numRootHit++;
+    }
+    return it->second.get();
+}
+
+shared_ptr<const HierarchyDesign> SimServer::FindSubtree(const string &rootKey, const vector<vector<double>> &designArch,
+                                                         int *numShared) const {
+    for ( int numLevel=designArch.size(); numLevel > 0; numLevel-- ) {
+        auto it = subtreeCache.find(getPrefixKey(rootKey, designArch, numLevel));
+        if ( it != subtreeCache.end() ) {
+            *numShared = numLevel;
+            return it->second;
+        }
+    }
+    *numShared = 0;
+    return nullptr;
+}
+
+void SimServer::AddSubtree(const string &rootKey, const shared_ptr<const HierarchyDesign> &hDesign) {
+    const vector<vector<double>> &designArch = hDesign->designArch;
+    for ( int numLevel=1; numLevel <= designArch.size(); numLevel++ ) {
+        subtreeCache[getPrefixKey(rootKey, designArch, numLevel)] = hDesign;
+    }
+    subtreeOrder.push_back(make_pair(rootKey, hDesign));
+
+    // oldest design dropped (its prefixes are kept if a later design has them, objects live while shared)
+    while ( subtreeOrder.size() > maxCachedDesign ) {
+        const string &oldRootKey = subtreeOrder.front().first;
+        const shared_ptr<const HierarchyDesign> &oldDesign = subtreeOrder.front().second;
+        for ( int numLevel=1; numLevel <= oldDesign->designArch.size(); numLevel++ ) {
+            auto it = subtreeCache.find(getPrefixKey(oldRootKey, oldDesign->designArch, numLevel));
+            if ( (it != subtreeCache.end()) && (it->second == oldDesign) ) {
+                subtreeCache.erase(it);
+            }
+        }
+        subtreeOrder.pop_front();
+    }
+}
+
+const ServerNetwork& SimServer::Prepare(const string &networkList, int _synapseBit, int _numBitInput, const vector<int> &_arrayParam,
+                                        HierarchyRoot **hRoot, string *rootKey, bool *rootHit) {
+
+    /* Network portfolio & precision of the hardware */
+    const ServerNetwork &network = GetNetwork(networkList, _synapseBit, _numBitInput);
+    param->synapseBit = network.synapseBit;
+    param->numBitInput = network.numBitInput;
+    param->cellBit = MIN(cellBit, param->synapseBit);
+    param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit);
+
+    /* CIM array (params of the array are used by the generator & scheduler) */
+    param->numRowCIMArray = _arrayParam[0];
+    param->numColCIMArray = _arrayParam[1];
+    param->levelOutput = _arrayParam[2];
+    param->numColMuxed = _arrayParam[3];
+    param->clkFreq = clkFreq;
+    ostringstream oss;
+    oss << joinKey(_arrayParam) << "|" << param->synapseBit << " " << param->numBitInput << "|" << clkFreq;
+    *rootKey = oss.str();
+    *hRoot = GetRoot(*rootKey, rootHit);
+    param->clkFreq = clkFreq;
+    return network;
+}
+
+ServerResult SimServer::EvaluateDesign(const string &networkList, int _synapseBit, int _numBitInput, int _scheduler_type,
+                                       const vector<int> &_arrayParam, const vector<vector<int>> &designParam, bool cache) {
+
+    HierarchyRoot *hRoot;
+    string rootKey;
+    bool rootHit;
+    const ServerNetwork &network = Prepare(networkList, _synapseBit, _numBitInput, _arrayParam, &hRoot, &rootKey, &rootHit);
+
+    /* generate architecture with design params */
+    archGenerator.Initialize(hRoot, network.networkStructureVector, _scheduler_type);
+    vector<vector<int>> designArch = archGenerator.Generate(designParam);
+    vector<vector<double>> designArch_db;
+    for ( auto &designHObj : designArch ) {
+        designArch_db.push_back(vector<double>(designHObj.begin(), designHObj.end()));
+    }
+
+    /* Result of the same design on the same networks */
+    string resultKey = networkList + "|" + to_string(_synapseBit) + " " + to_string(_numBitInput) + " " + to_string(_scheduler_type) + "|"
+                       + getPrefixKey(rootKey, designArch_db, designArch_db.size());
+    auto it = resultCache.find(resultKey);
+    if ( cache && (it != resultCache.end()) ) {
+        numResultHit++;
+        ServerResult cachedResult = it->second;
+        cachedResult.resultHit = true;
+        cachedResult.rootHit = true;
+        cachedResult.numShared = designArch.size();
+        return cachedResult;
+    }
+
+    ServerResult result = EvaluateArch(network, hRoot, rootKey, designArch_db, _scheduler_type, cache, NULL, NULL);
+    result.designArch = designArch;
+    result.rootHit = rootHit;
+    if ( cache ) {
+        resultCache[resultKey] = result;
+    }
+    return result;
+}
+
+ServerResult SimServer::EvaluateArch(const ServerNetwork &network, HierarchyRoot *hRoot, const string &rootKey,
+                                     const vector<vector<double>> &designArch_db, int _scheduler_type, bool cache,
+                                     const Evaluator *scheduleBase, Evaluator *evaluator) {
+
+    /* Architecture Design Initialization (lower levels from the subtree cache) */
+    int numHierarchy = designArch_db.size();
+    int numShared = 0;
+    shared_ptr<const HierarchyDesign> baseDesign;
+    if ( cache ) {
+        baseDesign = FindSubtree(rootKey, designArch_db, &numShared);
+    }
+    shared_ptr<HierarchyDesign> hDesign(new HierarchyDesign(inputParameter, tech, cell, hRoot, designArch_db));
+    hDesign->Initialize(param->clkFreq, baseDesign, numShared);
+    numSharedObject += hDesign->numShared;
+    numBuiltObject += numHierarchy - hDesign->numShared;
+    if ( cache ) {
+        AddSubtree(rootKey, hDesign);
+    }
+    vector<HierarchyObject*> &hObjectVector = hDesign->hObjectVector;
+    HierarchyObject *lastObject = hDesign->GetTop();
+
+    /* Architecture CLK Period Calculation */
+    double clkPeriod = 0;
+    hRoot->CalculateLatency(true, (double)hRoot->numRow, (double)hRoot->numCol, 1, 1, 1, &clkPeriod);
+    if ( param->clkFreq > 1/clkPeriod ) {
+        param->clkFreq = 1/clkPeriod;
+    }
+
+    /* Network Scheduling (or the mapping of scheduleBase) & Performance */
+    Evaluator localEvaluator;
+    if ( evaluator == NULL ) {
+        evaluator = &localEvaluator;
+    }
+    evaluator->Initialize(hRoot, hObjectVector, clkPeriod);
+    for ( int networkIdx=0; networkIdx < network.networkStructureVector_db.size(); networkIdx++ ) {
+        evaluator->AddNetwork(network.networkNames[networkIdx], network.networkStructureVector_db[networkIdx],
+                              network.networkWeights[networkIdx]);
+    }
+    if ( scheduleBase ) {
+        evaluator->ReuseSchedule(*scheduleBase);
+    } else {
+        evaluator->Scheduling(_scheduler_type);
+    }
+    evaluator->CalculatePerformance();
+    numEvaluated++;
+
+    ServerResult result;
+    result.designArch = toIntVector2(designArch_db);
+    result.clkPeriod = clkPeriod;
+    result.area = lastObject->areaVector[0];
+    result.energy = evaluator->dynamicEnergy + evaluator->leakageEnergy;
+    result.latency = evaluator->latency * clkPeriod;
+    result.power = result.energy / (evaluator->imageLatency * clkPeriod);
+    result.topsw = evaluator->topsw;
+    result.tops = evaluator->tops;
+
+    // breakdowns in s/J/m^2 (area of the hObjs scaled by the number of objects, as saved by main)
+    result.chipAreaVector = lastObject->areaVector;
+    for ( auto latency : evaluator->chipLatencyVector ) {
+        result.chipLatencyVector.push_back(latency * clkPeriod);
+    }
+    result.chipEnergyVector = evaluator->chipEnergyVector;
+    vector<vector<double>> chipAreaVector2;
+    for ( int h=0; h < numHierarchy; h++ ) {
+        chipAreaVector2.push_back(hObjectVector[h]->areaVector2);
+    }
+    result.areaVector2 = updateAreaVector2(&chipAreaVector2, result.chipAreaVector[0], numHierarchy, &hObjectVector);
+    for ( auto &latencyVector : evaluator->networkLatencyVector2 ) {
+        vector<double> tmpLatencyVector;
+        for ( auto latency : latencyVector ) {
+            tmpLatencyVector.push_back(latency * clkPeriod);
+        }
+        result.latencyVector2.push_back(tmpLatencyVector);
+    }
+    result.energyVector2 = evaluator->networkEnergyVector2;
+
+    for ( auto &networkEvaluation : evaluator->networkVector ) {
+        result.networkNames.push_back(networkEvaluation.name);
+        result.networkMetric.push_back({networkEvaluation.chipEnergyVector[0]+networkEvaluation.chipLeakageEnergy,
+                                        networkEvaluation.latency*clkPeriod, networkEvaluation.topsw, networkEvaluation.tops});
+    }
+    result.resultHit = false;
+    result.rootHit = true;
+    result.numShared = hDesign->numShared;
+    return result;
+}
@@ -6,6 +6,7 @@
 #include <string>
 #include <stdlib.h>
 #include <vector>
+#include <memory>
 #include <sstream>
 #include <chrono>
 #include <algorithm>
@@ -17,10 +18,11 @@
 #include "Definition.h"
 #include "util.h"
 #include "NetworkScheduler.h"
+#include "DesignError.h"
 
 using namespace std;
 
-int main(int argc, char * argv[]) {
+int main(int argc, char * argv[]) try {
     
     /* set const info */
     const int maxNumDU = 128;
@@ -70,8 +72,7 @@ int main(int argc, char * argv[]) {
     int totalExt = numInputExt * numOutputExt;
 
     /* get properties of CIM array output */
-    HierarchyRoot *hRoot;
-    hRoot = new HierarchyRoot(inputParameter, tech, cell);
+    unique_ptr<HierarchyRoot> hRoot(new HierarchyRoot(inputParameter, tech, cell));
     hRoot->Initialize();
     int bitArrayOut = (int)hRoot->numOutBit;
 
@@ -244,4 +245,8 @@ int main(int argc, char * argv[]) {
     /* save designArch */
     saveIntVector2(filename, &designArch);
 
+} catch ( const DesignError &e ) {
+    // the design params cannot be generated for the layer
+    cerr << "[Error] " << e.what() << endl;
+    return -1;
 }
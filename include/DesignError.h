@@ -0,0 +1,25 @@
+/*********************************************************************************************
+* Definition of the Design Error (invalid design point, thrown instead of exit(-1))
+*********************************************************************************************/
+
+#ifndef DESIGNERROR_H_
+#define DESIGNERROR_H_
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+/* Thrown by the circuit modules, architecture template & scheduler for a design that cannot be simulated.
+ * The batch DSE marks the design infeasible with the reason code, the other programs exit with the message. */
+class DesignError : public runtime_error {
+//private:
+public:
+    DesignError(const string &_reason, const string &message): runtime_error(message), reason(_reason) {}
+    virtual ~DesignError() throw() {}
+
+    string reason;      // reason code (e.g. subObjectOverflow)
+
+}; /* class DesignError */
+
+#endif /* DESIGNERROR_H_ */
@@ -0,0 +1,74 @@
+/*********************************************************************************************
+* Definition of the Json Value (minimal JSON for the line-delimited protocol of sage_server)
+*********************************************************************************************/
+
+#ifndef JSON_H_
+#define JSON_H_
+
+#include <vector>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+enum JsonType {
+    JSON_NULL = 0,
+    JSON_BOOL = 1,
+    JSON_NUMBER = 2,
+    JSON_STRING = 3,
+    JSON_ARRAY = 4,
+    JSON_OBJECT = 5
+};
+
+/* JSON value (members of an object are kept in insertion order)
+ * Parse throws a runtime_error for a malformed text, the accessors for a value of another type */
+class JsonValue {
+//private:
+public:
+    JsonValue(): type(JSON_NULL), boolean(false), number(0) {}
+    JsonValue(bool _boolean): type(JSON_BOOL), boolean(_boolean), number(0) {}
+    JsonValue(int _number): type(JSON_NUMBER), boolean(false), number(_number) {}
+    JsonValue(double _number): type(JSON_NUMBER), boolean(false), number(_number) {}
+    JsonValue(const char *_str): type(JSON_STRING), boolean(false), number(0), str(_str) {}
+    JsonValue(const string &_str): type(JSON_STRING), boolean(false), number(0), str(_str) {}
+    JsonValue(const vector<double> &values);
+    JsonValue(const vector<int> &values);
+    template <typename T>
+    JsonValue(const vector<vector<T>> &values): type(JSON_ARRAY), boolean(false), number(0) {
+        for ( auto &row : values ) {
+            array.push_back(JsonValue(row));
+        }
+    }
+    virtual ~JsonValue() {}
+
+    /* Functions */
+    static JsonValue Parse(const string &text);
+    static JsonValue Array() { JsonValue value; value.type = JSON_ARRAY; return value; }
+    static JsonValue Object() { JsonValue value; value.type = JSON_OBJECT; return value; }
+    string Dump() const;    // single line (no newline in the text)
+
+    // members of an object (Set replaces an existing member)
+    bool Has(const string &key) const;
+    const JsonValue& Get(const string &key) const;
+    void Set(const string &key, const JsonValue &value);
+    void Append(const JsonValue &value) { array.push_back(value); }
+
+    // typed access
+    bool AsBool() const;
+    double AsNumber() const;
+    int AsInt() const;
+    const string& AsString() const;
+    vector<int> AsIntVector() const;
+    vector<vector<int>> AsIntVector2() const;
+
+    /* Properties */
+    JsonType type;
+    bool boolean;
+    double number;
+    string str;
+    vector<JsonValue> array;
+    vector<pair<string, JsonValue>> object;
+
+}; /* class JsonValue */
+
+#endif /* JSON_H_ */
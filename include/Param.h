@@ -40,6 +40,7 @@
 #define PARAM_H_
 
 #include<vector>
+#include<string>
 
 using namespace std;
 
@@ -47,6 +48,11 @@ class Param {
 public:
 	Param();
 
+    // override parameters with command line arguments (name=value)
+    void ReadParamArgs(int argc, char *argv[], int firstArg);
+    bool SetParam(const string &name, double value);
+    void ReadActivityProfile(const string &filename);
+
 	int operationmode, operationmodeBack, memcelltype, accesstype, transistortype, deviceroadmap;      		
 	
 	double heightInFeatureSizeSRAM, widthInFeatureSizeSRAM, widthSRAMCellNMOS, widthSRAMCellPMOS, widthAccessCMOS, minSenseVoltage;
@@ -74,10 +80,21 @@ public:
     //DICE
     double inputActiveRatio;
     vector<double> weightLevelRatioVector;
+    vector<vector<double>> activityProfile; // input active ratio of each layer (row) & bitplane (col, LSB first)
+    vector<string> paramArgs;               // overrides of the command line (name=value), in order
 
 	int numRowCIMArray, numColCIMArray;
 	int cellBit, synapseBit;
 	int speedUpDegree;
+	int batchSize, topBufferImage;
+	double replicaBudget;
+	int meshModel, meshBufferDepth;
+	int inputOverlap;
+	int pingPongBuffer;
+	int powerGating, powerGatingLevel;
+	double powerGatingWakeUp;
+	int monteCarlo, monteCarloSeed;
+	double sigmaResistance;
 	
 	int XNORparallelMode, XNORsequentialMode, BNNparallelMode, BNNsequentialMode, conventionalParallel, conventionalSequential; 
 	int numRowPerSynapse, numColPerSynapse;
@@ -18,6 +18,33 @@ using namespace std;
 
 vector<vector<double>> readCSV(const string &inputfile);
 vector<vector<int>> readCSVint(const string &inputfile);
+
+/* Network portfolio: comma-separated network files with optional weights (file[:weight], default 1)
+ * a single network file is a portfolio of one network */
+void readNetworkList(const string &networkList, vector<string> *networkFiles, vector<double> *networkWeights);
+string getNetworkName(const string &networkFile);
+
+/* Peak resident set size of the program [KB] */
+long getPeakRSS();
+
+/* Per-layer precision of the network (9-wbits, 10-abits of the network csv)
+ * the columns not given (or 0) are filled with the default precision, and the highest precision of
+ * the network is returned in synapseBit/numBitInput as the hardware has to support every layer */
+template <typename T>
+void setLayerPrecision(vector<vector<T>> &networkStructure, int *synapseBit, int *numBitInput) {
+    int maxSynapseBit = 0, maxNumBitInput = 0;
+    for ( auto &layerStructure : networkStructure ) {
+        if ( layerStructure.size() < 11 ) {
+            layerStructure.resize(11, 0);
+        }
+        if ( layerStructure[9] <= 0 ) { layerStructure[9] = *synapseBit; }
+        if ( layerStructure[10] <= 0 ) { layerStructure[10] = *numBitInput; }
+        maxSynapseBit = ( maxSynapseBit < (int)layerStructure[9] )? (int)layerStructure[9] : maxSynapseBit;
+        maxNumBitInput = ( maxNumBitInput < (int)layerStructure[10] )? (int)layerStructure[10] : maxNumBitInput;
+    }
+    *synapseBit = maxSynapseBit;
+    *numBitInput = maxNumBitInput;
+}
 void saveIntVector2(const string &filename,
         const vector<vector<int>> *intVector2);
 void printIntVector2(const vector<vector<int>> *intVector2);
@@ -26,6 +53,10 @@ void printIntVector2(const vector<vector<int>> *intVector2);
 void savePerformanceMetric(int archIdx, const string &filename, 
                         int numHierarchy, double performance);
 
+// save per-network metrics of a network portfolio (energy_with_leakage, latency, topsw, tops)
+void savePortfolioMetric(int archIdx, const string &filename, int numHierarchy,
+                        const string &network, double weight, const vector<double> &metrics);
+
 // performanceType: 0 - latency, 1 - dynamicEnergy, 2 - area
 void savePerformanceVector(int performanceType, const string &filename,
         const string &indicator_header, const string &indicator,
@@ -44,6 +44,7 @@
 #include <string>
 #include <stdlib.h>
 #include <vector>
+#include <memory>
 #include <sstream>
 #include <chrono>
 #include <algorithm>
@@ -51,15 +52,18 @@
 #include "formula.h"
 #include "HierarchyRoot.h"
 #include "HierarchyObject.h"
+#include "HierarchyDesign.h"
 #include "Param.h"
 #include "Definition.h"
 #include "util.h"
 #include "NetworkScheduler.h"
+#include "MonteCarlo.h"
+#include "DesignError.h"
 
 using namespace std;
 
 
-int main(int argc, char * argv[]) {
+int main(int argc, char * argv[]) try {
 
 	auto start = chrono::high_resolution_clock::now();
 	
@@ -77,6 +81,7 @@ int main(int argc, char * argv[]) {
 	// define weight/input/memory precision from wrapper
 	param->synapseBit = atoi(argv[3]);              // precision of synapse weight
 	param->numBitInput = atoi(argv[4]);             // precision of input neural activation
+	setLayerPrecision(networkStructure, &param->synapseBit, &param->numBitInput); // per-layer precision (max for hardware)
 	if (param->cellBit > param->synapseBit) {
 		cout << "ERROR!: Memory precision is even higher than synapse precision, please modify 'cellBit' in Param.cpp!" << endl;
 		param->cellBit = param->synapseBit;
@@ -84,6 +89,9 @@ int main(int argc, char * argv[]) {
     
     int scheduler_type = atoi(argv[5]);
 
+    // optional parameter overrides (name=value)
+    param->ReadParamArgs(argc, argv, 6);
+
     double numComputation = 0;
     for (int i=0; i<networkStructure.size(); i++) {
         //numComputation += 2*( networkStructure[i][0] * networkStructure[i][1] * networkStructure[i][2] 
@@ -114,29 +122,20 @@ int main(int argc, char * argv[]) {
 	param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit); 
 
     /* Architecture Design Initialization (Initialization include area calculation) */
-    HierarchyRoot *hRoot;
-    HierarchyObject *prevObject;
-    HierarchyObject *lastObject;
-    vector<HierarchyObject*> hObjectVector;
     printf("---------- Start Object Initialization ----------\n");
-    for (int h=0; h < (numHierarchy + 1); h++) {
-        printf("Initialize %d-level object\n",h);
-        if ( h==0 ) {
-            hRoot = new HierarchyRoot(inputParameter, tech, cell);
-            hRoot->Initialize();
-        } else {
-            lastObject = new HierarchyObject(inputParameter, tech, cell, h, hRoot, prevObject, designArch[h-1]);
-            lastObject->Initialize(param->clkFreq);
-
-            hObjectVector.push_back(lastObject);
-            prevObject = lastObject;
-        }
-    }
+    printf("Initialize 0-level object\n");
+    unique_ptr<HierarchyRoot> hRoot(new HierarchyRoot(inputParameter, tech, cell));
+    hRoot->Initialize();
+
+    HierarchyDesign hDesign(inputParameter, tech, cell, hRoot.get(), designArch);
+    hDesign.Initialize(param->clkFreq);
+    vector<HierarchyObject*> &hObjectVector = hDesign.hObjectVector;
+    HierarchyObject *lastObject = hDesign.GetTop();
     printf("---------- Finish Object Initialization ----------\n\n");
 
     /* Architecture CLK Period Calculation */
-    double clkPeriod;
-    hRoot->CalculateLatency(true, (double)hRoot->numCol, (double)hRoot->numRow, 1, 1, 1, &clkPeriod);
+    double clkPeriod = 0;
+    hRoot->CalculateLatency(true, (double)hRoot->numRow, (double)hRoot->numCol, 1, 1, 1, &clkPeriod);
     if ( param->clkFreq > 1/clkPeriod ) {
         param->clkFreq = 1/clkPeriod;
     }
@@ -155,19 +154,36 @@ int main(int argc, char * argv[]) {
 
 
     /* Network Scheduling */
-    NetworkScheduler *networkScheduler = new NetworkScheduler();
-    networkScheduler->Initialize(networkStructure, hObjectVector[numHierarchy-1]);
-    vector<vector<double>> networkInfoRead = networkScheduler->Scheduling(scheduler_type);
+    NetworkScheduler networkScheduler;
+    networkScheduler.Initialize(networkStructure, hObjectVector[numHierarchy-1]);
+    // weight replication on the spare top-level subObjects
+    if ( param->replicaBudget > 0 ) {
+        networkScheduler.BalanceReplica(scheduler_type, hRoot.get(), hObjectVector);
+    }
+    const InfoReadTable &networkInfoRead = networkScheduler.Scheduling(scheduler_type);
+    // write scheduling results to the csv file
+    networkInfoRead.SaveCSV("scheduling_result.csv");
 
     /* Architecture latency Measurement */
     vector<vector<double>> networkLatencyVector, networkEnergyVector;
     vector<vector<double>> layerLatencyVector2, layerEnergyVector2, networkLatencyVector2, networkEnergyVector2;
     vector<double> chipLatencyVector, chipEnergyVector;
 
-    networkScheduler->CalculatePerformance(&networkLatencyVector, &networkEnergyVector, 
+    networkScheduler.CalculatePerformance(&networkLatencyVector, &networkEnergyVector, 
                                            &layerLatencyVector2, &layerEnergyVector2,
                                            &networkLatencyVector2, &networkEnergyVector2, 
-                                           hRoot, hObjectVector, networkInfoRead);
+                                           hRoot.get(), hObjectVector, networkInfoRead);
+
+    /* Pipelined execution (latency per image in steady state = pipeline interval, stages of the batch) */
+    if ( param->pipeline || (param->batchSize > 1) ) {
+        networkScheduler.CalculatePipeline(&layerLatencyVector2);
+    }
+
+    /* Power gating of the units idle in each layer (average leakage power) */
+    if ( param->powerGating ) {
+        chipLeakage = networkScheduler.CalculatePowerGating(chipLeakage, hRoot.get(), hObjectVector, 
+                                                            networkInfoRead, &networkLatencyVector);
+    }
 
     double clkPeriod_ns = clkPeriod * 1e9;
 
@@ -207,7 +223,15 @@ int main(int argc, char * argv[]) {
     /* Print Summary */
     printf("\n-------------------- Summary --------------------\n");
 
-    double chipLeakageEnergy = chipLeakage * chipLatencyVector[0] * clkPeriod;   
+    /* Batched execution */
+    networkScheduler.CalculateBatch(param->batchSize, chipLatencyVector[0]);
+
+    // latency per image (pipeline interval in steady state, average over the batch for batched execution)
+    double imageLatency = param->pipeline? networkScheduler.pipelineInterval: chipLatencyVector[0];
+    if ( param->batchSize > 1 ) {
+        imageLatency = networkScheduler.batchLatency / param->batchSize;
+    }
+    double chipLeakageEnergy = chipLeakage * imageLatency * clkPeriod;   
     cout << "Chip clock period is: " << clkPeriod_ns << "ns" << endl;
     printf("%-20s %15.4e ns\n", "Chip clock period", clkPeriod_ns);
     printf("%-20s %15.4e uW\n", "Chip leakagePower", chipLeakage*1e6);
@@ -266,13 +290,57 @@ int main(int argc, char * argv[]) {
     printf("(Accumulation Circuits - subarray level: adders, shiftAdds; PE/Tile/Global level: accumulation units)\n");
     printf("(Other Peripheries     - pooling and activation units)\n");
 
+    if ( param->pipeline ) {
+        printf("---------- Pipeline ----------\n");
+        for (auto& stage : networkScheduler.pipelineStageVector) {
+            printf("Stage (layer %3d)    %15.4e ns                [%5.1f cycle] + top %5.1f cycle\n", (int)stage[0],
+                                                            stage[1]*clkPeriod_ns, stage[1], stage[2]);
+        }
+        printf("%-20s %15.4e ns                [%5.1f cycle]\n", "Shared top DE/BU/IC",
+                                                            networkScheduler.pipelineSharedLatency*clkPeriod_ns,
+                                                            networkScheduler.pipelineSharedLatency);
+        printf("%-20s %15.4e ns                [%5.1f cycle]\n", "Pipeline interval",
+                                                            networkScheduler.pipelineInterval*clkPeriod_ns,
+                                                            networkScheduler.pipelineInterval);
+        printf("%-20s %15.4e ns                [%5.1f cycle]\n", "Pipeline latency",
+                                                            networkScheduler.pipelineLatency*clkPeriod_ns,
+                                                            networkScheduler.pipelineLatency);
+        if ( networkScheduler.pipelineBottleneck < 0 ) {
+            printf("(Bottleneck: top-level DE/BU/IC shared by the stages)\n");
+        } else {
+            printf("(Bottleneck: top-level subObject %d)\n", networkScheduler.pipelineBottleneck);
+        }
+    }
+
+    if ( param->batchSize > 1 ) {
+        printf("---------- Batch ----------\n");
+        printf("%-20s %15d\n", "Batch size", param->batchSize);
+        printf("%-20s %15d (fmap %.0f bit, top buffer %d bit)\n", "Images in flight", networkScheduler.numImageInFlight,
+                                                            networkScheduler.fmapBit,
+                                                            lastObject->bufferUnit->outBUSize + lastObject->bufferUnit->inBUSize);
+        printf("%-20s %15.4e ns                [%5.1f cycle]\n", "Batch interval",
+                                                            networkScheduler.batchInterval*clkPeriod_ns,
+                                                            networkScheduler.batchInterval);
+        printf("%-20s %15.4e ns                [%5.1f cycle]\n", "Batch latency",
+                                                            networkScheduler.batchLatency*clkPeriod_ns,
+                                                            networkScheduler.batchLatency);
+        printf("(Energy efficiency/throughput below are averaged over the batch)\n");
+    }
 
     printf("---------- Performance ----------\n");
     //printf("%-20s %15.4f TBOPS/W\n", "Energy Efficiency", numComputation/(chipEnergyVector[0]+chipLeakageEnergy)/1e12);
     //printf("%-20s %15.4f TBOPS\n", "Throughput", numComputation/(chipLatencyVector[0]*clkPeriod)/1e12);
     printf("%-20s %15.4f TOPS/W\n", "Energy Efficiency", numComputation/(chipEnergyVector[0]+chipLeakageEnergy)/1e12);
-    printf("%-20s %15.4f TOPS\n", "Throughput", numComputation/(chipLatencyVector[0]*clkPeriod)/1e12);
-
+    printf("%-20s %15.4f TOPS\n", "Throughput", numComputation/(imageLatency*clkPeriod)/1e12);
+
+    /* Monte Carlo device variation (reuses the schedule) */
+    if ( param->monteCarlo > 0 ) {
+        MonteCarlo monteCarlo;
+        monteCarlo.Initialize(hRoot.get(), hObjectVector, networkInfoRead);
+        monteCarlo.Run(param->monteCarlo);
+        monteCarlo.PrintResult();
+        monteCarlo.SaveCSV("./results/monteCarlo.csv");
+    }
 
     printf("[START] Saving Simulation Results to CSV file \n");
 
@@ -313,5 +381,10 @@ int main(int argc, char * argv[]) {
 
 	
     printf("[FINISH] Saving Simulation Results to CSV file \n");
+    printf("Peak RSS: %ld KB\n", getPeakRSS());
 
+} catch ( const DesignError &e ) {
+    // the designArch cannot be simulated with the network
+    cerr << "[Error] " << e.what() << endl;
+    return -1;
 }
@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdlib.h>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include "constant.h"
+#include "formula.h"
+#include "HierarchyRoot.h"
+#include "Param.h"
+#include "Definition.h"
+#include "util.h"
+#include "DesignSpace.h"
+#include "BatchEngine.h"
+#include "SearchDriver.h"
+#include "DesignError.h"
+
+using namespace std;
+
+/* Batch DSE: arch_generator_for_net + main_iter for every design point of the design space in a single process
+ * usage: main_dse dseConfig.csv network(s) wbits abits scheduler_type basefolder [name=value ...] */
+int main(int argc, char * argv[]) try {
+
+    auto start = chrono::high_resolution_clock::now();
+
+    gen.seed(0);
+
+    // network portfolio (comma-separated network files with optional weights, file[:weight])
+    vector<string> networkFiles;
+    vector<double> networkWeights;
+    vector<string> networkNames;
+    vector<vector<vector<int>>> networkStructureVector;
+    readNetworkList(argv[2], &networkFiles, &networkWeights);
+
+    // define weight/input/memory precision from wrapper
+    param->synapseBit = 0;
+    param->numBitInput = 0;
+    for ( auto &networkFile : networkFiles ) {
+        vector<vector<int>> networkStructure = readCSVint(networkFile);
+        int synapseBit = atoi(argv[3]);     // precision of synapse weight
+        int numBitInput = atoi(argv[4]);    // precision of input neural activation
+        setLayerPrecision(networkStructure, &synapseBit, &numBitInput); // per-layer precision (max for hardware)
+        param->synapseBit = MAX(param->synapseBit, synapseBit);
+        param->numBitInput = MAX(param->numBitInput, numBitInput);
+        networkStructureVector.push_back(networkStructure);
+        networkNames.push_back(getNetworkName(networkFile));
+    }
+    if (param->cellBit > param->synapseBit) {
+        cout << "ERROR!: Memory precision is even higher than synapse precision, please modify 'cellBit' in Param.cpp!" << endl;
+        param->cellBit = param->synapseBit;
+    }
+    param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit);
+
+    int scheduler_type = atoi(argv[5]);
+    string basefolder = argv[6];
+
+    // optional parameter overrides (name=value)
+    param->ReadParamArgs(argc, argv, 7);
+
+    /* Design space (CIM array x hierarchy) */
+    DesignSpace designSpace;
+    designSpace.ReadConfig(argv[1]);
+    designSpace.Enumerate();
+
+    /* Batch DSE */
+    BatchEngine batchEngine(inputParameter, tech, cell);
+    batchEngine.Initialize(&designSpace, networkStructureVector, networkNames, networkWeights, scheduler_type, basefolder);
+    if ( designSpace.searchPopulation > 0 ) {
+        SearchDriver searchDriver(&designSpace, &batchEngine);
+        searchDriver.Run();
+    } else {
+        batchEngine.Run();
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    printf("Batch DSE finished in %.2f s\n", chrono::duration<double>(end - start).count());
+
+} catch ( const DesignError &e ) {
+    // each design records its own error, so this one comes from the setup of the sweep
+    cerr << "[Error] " << e.what() << endl;
+    return -1;
+}
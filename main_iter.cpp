@@ -44,6 +44,7 @@
 #include <string>
 #include <stdlib.h>
 #include <vector>
+#include <memory>
 #include <sstream>
 #include <chrono>
 #include <algorithm>
@@ -51,15 +52,18 @@
 #include "formula.h"
 #include "HierarchyRoot.h"
 #include "HierarchyObject.h"
+#include "HierarchyDesign.h"
 #include "Param.h"
 #include "Definition.h"
 #include "util.h"
 #include "NetworkScheduler.h"
+#include "Evaluator.h"
+#include "DesignError.h"
 
 using namespace std;
 
 
-int main(int argc, char * argv[]) {
+int main(int argc, char * argv[]) try {
 
 	auto start = chrono::high_resolution_clock::now();
 	
@@ -69,14 +73,28 @@ int main(int argc, char * argv[]) {
 	vector<vector<double>> designArch;
     vector<vector<double>> networkStructure;
 	designArch = readCSV(argv[1]);
-    networkStructure = readCSV(argv[2]);
+
+    // network portfolio (comma-separated network files with optional weights, file[:weight])
+    vector<string> networkFiles;
+    vector<double> networkWeights;
+    vector<vector<vector<double>>> networkStructureVector;
+    readNetworkList(argv[2], &networkFiles, &networkWeights);
 
     int numHierarchy = designArch.size();
-    int numLayer = networkStructure.size();
 
 	// define weight/input/memory precision from wrapper
-	param->synapseBit = atoi(argv[3]);              // precision of synapse weight
-	param->numBitInput = atoi(argv[4]);             // precision of input neural activation
+	param->synapseBit = 0;
+	param->numBitInput = 0;
+	for ( auto &networkFile : networkFiles ) {
+		networkStructure = readCSV(networkFile);
+		int synapseBit = atoi(argv[3]);             // precision of synapse weight
+		int numBitInput = atoi(argv[4]);            // precision of input neural activation
+		setLayerPrecision(networkStructure, &synapseBit, &numBitInput); // per-layer precision (max for hardware)
+		param->synapseBit = MAX(param->synapseBit, synapseBit);
+		param->numBitInput = MAX(param->numBitInput, numBitInput);
+		networkStructureVector.push_back(networkStructure);
+	}
+	networkStructure = networkStructureVector[0];
 	if (param->cellBit > param->synapseBit) {
 		cout << "ERROR!: Memory precision is even higher than synapse precision, please modify 'cellBit' in Param.cpp!" << endl;
 		param->cellBit = param->synapseBit;
@@ -86,14 +104,9 @@ int main(int argc, char * argv[]) {
     int archIdx = atoi(argv[6]);
     string basefolder = argv[7];
 
-    double numComputation = 0;
-    for (int i=0; i<networkStructure.size(); i++) {
-        //numComputation += 2*( networkStructure[i][0] * networkStructure[i][1] * networkStructure[i][2] 
-        //                        * networkStructure[i][3] * networkStructure[i][4] * networkStructure[i][5] )
-        //                  * param->synapseBit * param->numBitInput;
-        numComputation += 2*( networkStructure[i][0] * networkStructure[i][1] * networkStructure[i][2] 
-                                * networkStructure[i][3] * networkStructure[i][4] * networkStructure[i][5] );
-    }
+    // optional parameter overrides (name=value)
+    param->ReadParamArgs(argc, argv, 8);
+
 	
 	/*** initialize operationMode as default ***/
 	param->conventionalParallel = 0;
@@ -116,36 +129,24 @@ int main(int argc, char * argv[]) {
 	param->numColPerSynapse = ceil((double)param->synapseBit/(double)param->cellBit); 
 
     /* Architecture Design Initialization (Initialization include area calculation) */
-    HierarchyRoot *hRoot;
-    HierarchyObject *prevObject;
-    HierarchyObject *lastObject;
-    vector<HierarchyObject*> hObjectVector;
     printf("---------- Start Object Initialization ----------\n");
-    for (int h=0; h < (numHierarchy + 1); h++) {
-        printf("Initialize %d-level object\n",h);
-        if ( h==0 ) {
-            hRoot = new HierarchyRoot(inputParameter, tech, cell);
-            hRoot->Initialize();
-        } else {
-            lastObject = new HierarchyObject(inputParameter, tech, cell, h, hRoot, prevObject, designArch[h-1]);
-            lastObject->Initialize(param->clkFreq);
-
-            hObjectVector.push_back(lastObject);
-            prevObject = lastObject;
-        }
-    }
+    printf("Initialize 0-level object\n");
+    unique_ptr<HierarchyRoot> hRoot(new HierarchyRoot(inputParameter, tech, cell));
+    hRoot->Initialize();
+
+    HierarchyDesign hDesign(inputParameter, tech, cell, hRoot.get(), designArch);
+    hDesign.Initialize(param->clkFreq);
+    vector<HierarchyObject*> &hObjectVector = hDesign.hObjectVector;
+    HierarchyObject *lastObject = hDesign.GetTop();
     printf("---------- Finish Object Initialization ----------\n\n");
 
     /* Architecture CLK Period Calculation */
-    double clkPeriod;
-    hRoot->CalculateLatency(true, (double)hRoot->numCol, (double)hRoot->numRow, 1, 1, 1, &clkPeriod);
+    double clkPeriod = 0;
+    hRoot->CalculateLatency(true, (double)hRoot->numRow, (double)hRoot->numCol, 1, 1, 1, &clkPeriod);
     if ( param->clkFreq > 1/clkPeriod ) {
         param->clkFreq = 1/clkPeriod;
     }
 
-    /* Get Architecture leakage information */
-    double chipLeakage = lastObject->leakage; 
-
     /* Get Architecture area information */
     vector<double> chipAreaVector = lastObject->areaVector;
     
@@ -155,44 +156,29 @@ int main(int argc, char * argv[]) {
         chipAreaVector2.push_back(tmpObject->areaVector2);
     }
 
-    /* Network Scheduling */
-    NetworkScheduler *networkScheduler = new NetworkScheduler();
-    networkScheduler->Initialize(networkStructure, hObjectVector[numHierarchy-1]);
-    vector<vector<double>> networkInfoRead = networkScheduler->Scheduling(scheduler_type);
-
-    /* Architecture latency Measurement */
-    vector<vector<double>> networkLatencyVector, networkEnergyVector;
-    vector<vector<double>> layerLatencyVector2, layerEnergyVector2, networkLatencyVector2, networkEnergyVector2;
-    vector<double> chipLatencyVector, chipEnergyVector;
+    /* Network Scheduling (the hierarchy is shared by the networks of the portfolio) */
+    Evaluator evaluator;
+    evaluator.Initialize(hRoot.get(), hObjectVector, clkPeriod);
+    for ( int networkIdx=0; networkIdx < networkFiles.size(); networkIdx++ ) {
+        evaluator.AddNetwork(getNetworkName(networkFiles[networkIdx]), networkStructureVector[networkIdx],
+                             networkWeights[networkIdx]);
+    }
+    evaluator.Scheduling(scheduler_type);
+    // write scheduling results to the csv file
+    for ( auto &network : evaluator.networkVector ) {
+        string filename = ( networkFiles.size() > 1 )? "scheduling_result_" + network.name + ".csv" : "scheduling_result.csv";
+        network.networkScheduler.networkInfoRead.SaveCSV(filename);
+    }
 
-    networkScheduler->CalculatePerformance(&networkLatencyVector, &networkEnergyVector, 
-                                           &layerLatencyVector2, &layerEnergyVector2,
-                                           &networkLatencyVector2, &networkEnergyVector2, 
-                                           hRoot, hObjectVector, networkInfoRead);
+    /* Architecture latency Measurement (per network & weighted aggregate) */
+    evaluator.CalculatePerformance();
 
     double clkPeriod_ns = clkPeriod * 1e9;
-
-    /* Mergy latency / energy info */
-    for (int layerIdx=0; layerIdx < networkLatencyVector.size(); layerIdx++) {
-
-        vector<double> latencyVector = networkLatencyVector[layerIdx];
-        vector<double> readDynamicEnergyVector = networkEnergyVector[layerIdx];
-
-        // merge latency / energy info
-        if ( chipLatencyVector.size() == 0 ) {
-            chipLatencyVector.assign(latencyVector.begin(), latencyVector.end());
-            chipEnergyVector.assign(readDynamicEnergyVector.begin(), readDynamicEnergyVector.end());
-        } else {
-            for (int latencyIdx=0; latencyIdx < latencyVector.size(); latencyIdx++) {
-                chipLatencyVector[latencyIdx] += latencyVector[latencyIdx];
-            }
-            for (int energyIdx=0; energyIdx < readDynamicEnergyVector.size(); energyIdx++) {
-                chipEnergyVector[energyIdx] += readDynamicEnergyVector[energyIdx];
-            }
-        }
-
-    }
-    double chipLeakageEnergy = chipLeakage * chipLatencyVector[0] * clkPeriod;   
+    vector<double> &chipLatencyVector = evaluator.chipLatencyVector;
+    vector<double> &chipEnergyVector = evaluator.chipEnergyVector;
+    vector<vector<double>> &networkLatencyVector2 = evaluator.networkLatencyVector2;
+    vector<vector<double>> &networkEnergyVector2 = evaluator.networkEnergyVector2;
+    double chipLeakageEnergy = evaluator.leakageEnergy;
 
     ///* Print Performance (latency/power) Information (breakdown type1) */
     //printLatencyVector(&networkLatencyVector2, chipLatencyVector[0], clkPeriod_ns, numHierarchy, numLayer, true, false);
@@ -263,8 +249,15 @@ int main(int argc, char * argv[]) {
 
 
     printf("---------- [ArchIdx: %8d] Performance ----------\n", archIdx);
-    double topsw = numComputation/(chipEnergyVector[0]+chipLeakageEnergy)/1e12;
-    double tops = numComputation/(chipLatencyVector[0]*clkPeriod)/1e12;
+    double topsw = evaluator.topsw;
+    double tops = evaluator.tops;
+    if ( evaluator.networkVector.size() > 1 ) {
+        for ( auto &network : evaluator.networkVector ) {
+            printf("%-20s %15.4f TOPS/W %15.4f TOPS (weight %.3f)\n", network.name.c_str(), 
+                                                            network.topsw, network.tops, network.weight);
+        }
+        printf("(Weighted aggregate below)\n");
+    }
     printf("%-20s %15.4e mm^2\n", "Chip Area", chipAreaVector[0]*1e12/1e6);
     printf("%-20s %15.4f TOPS/W\n", "Energy Efficiency", topsw);
     printf("%-20s %15.4f TOPS\n", "Throughput", tops);
@@ -313,7 +306,7 @@ int main(int argc, char * argv[]) {
     savePerformanceMetric(archIdx, filename, numHierarchy, (chipEnergyVector[0]+chipLeakageEnergy)*1e12);
 
     filename = basefolder + "/latency.csv";
-    savePerformanceMetric(archIdx, filename, numHierarchy, (chipLatencyVector[0]*clkPeriod)*1e12);
+    savePerformanceMetric(archIdx, filename, numHierarchy, (evaluator.latency*clkPeriod)*1e12);
 	
     filename = basefolder + "/topsw.csv";
     savePerformanceMetric(archIdx, filename, numHierarchy, topsw);
@@ -324,7 +317,21 @@ int main(int argc, char * argv[]) {
     filename = basefolder + "/area.csv";
     savePerformanceMetric(archIdx, filename, numHierarchy, chipAreaVector[0]*1e12);
 
+    // per-network metrics of the portfolio
+    if ( evaluator.networkVector.size() > 1 ) {
+        filename = basefolder + "/portfolio.csv";
+        for ( auto &network : evaluator.networkVector ) {
+            savePortfolioMetric(archIdx, filename, numHierarchy, network.name, network.weight,
+                                {(network.chipEnergyVector[0]+network.chipLeakageEnergy)*1e12,
+                                 (network.latency*clkPeriod)*1e12, network.topsw, network.tops});
+        }
+    }
+
 
     printf("[FINISH] Saving Simulation Results to CSV file \n");
 
+} catch ( const DesignError &e ) {
+    // the designArch cannot be simulated with the network portfolio
+    cerr << "[Error] " << e.what() << endl;
+    return -1;
 }
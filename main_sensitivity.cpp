@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+#include <vector>
+#include "constant.h"
+#include "formula.h"
+#include "HierarchyRoot.h"
+#include "Param.h"
+#include "Definition.h"
+#include "util.h"
+#include "SimServer.h"
+#include "Sensitivity.h"
+#include "DesignError.h"
+
+using namespace std;
+
+/* Sensitivity analysis: normalized partial derivatives of area/energy/latency over the design & Param knobs of a design
+ * usage: main_sensitivity designParam.csv network(s) wbits abits scheduler_type outfile [step=0.1] [verify=1] [name=value ...] */
+int main(int argc, char * argv[]) try {
+
+    gen.seed(0);
+
+    if ( argc < 7 ) {
+        cerr << "usage: main_sensitivity designParam.csv network(s) wbits abits scheduler_type outfile [step=0.1] [verify=1] [name=value ...]" << endl;
+        return -1;
+    }
+    vector<vector<int>> designParam = readCSVint(argv[1]);
+    string networkList = argv[2];
+    int synapseBit = atoi(argv[3]);     // default precision of synapse weight
+    int numBitInput = atoi(argv[4]);    // default precision of input neural activation
+    int scheduler_type = atoi(argv[5]);
+    string filename = argv[6];
+
+    // options of the analysis, the other arguments are parameter overrides (name=value)
+    double step = 0.1;
+    bool verify = false;
+    vector<char*> paramArgs(argv, argv + 7);
+    for ( int argIdx=7; argIdx < argc; argIdx++ ) {
+        string arg = argv[argIdx];
+        if ( arg.compare(0, 5, "step=") == 0 ) {
+            step = atof(arg.substr(5).c_str());
+        } else if ( arg.compare(0, 7, "verify=") == 0 ) {
+            verify = ( atoi(arg.substr(7).c_str()) != 0 );
+        } else {
+            paramArgs.push_back(argv[argIdx]);
+        }
+    }
+    if ( step <= 0 ) {
+        cerr << "[Error] step of the sensitivity analysis should be positive" << endl;
+        exit(-1);
+    }
+    param->ReadParamArgs(paramArgs.size(), paramArgs.data(), 7);
+
+    SimServer simServer(inputParameter, tech, cell);
+    simServer.Initialize(synapseBit, numBitInput, scheduler_type);
+    Sensitivity sensitivity(&simServer);
+    sensitivity.Initialize(networkList, designParam, scheduler_type, step, verify);
+    sensitivity.Run();
+    sensitivity.Save(filename);
+
+    if ( verify ) {
+        // the reused subtrees & schedules should give the results of the evaluations from scratch
+        double maxVerifyError = 0;
+        for ( auto &sResult : sensitivity.resultVector ) {
+            maxVerifyError = MAX(maxVerifyError, sResult.verifyError);
+        }
+        printf("---------- Sensitivity: max relative difference to the evaluations from scratch %.3e ----------\n", maxVerifyError);
+        if ( maxVerifyError > 1e-9 ) {
+            cerr << "[Error] perturbations with reuse differ from the evaluations from scratch" << endl;
+            return -1;
+        }
+    }
+
+} catch ( const DesignError &e ) {
+    // an infeasible perturbation is recorded, so this is an error of the base design
+    cerr << "[Error] " << e.what() << endl;
+    return -1;
+}
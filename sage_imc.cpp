@@ -0,0 +1,333 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include "constant.h"
+#include "formula.h"
+#include "HierarchyRoot.h"
+#include "Param.h"
+#include "Definition.h"
+#include "util.h"
+#include "SimServer.h"
+#include "DesignError.h"
+
+using namespace std;
+
+/* Python extension module: the evaluator of sage_server in process (no program runs or csv round trips)
+ * The simulator keeps its parameters in process-wide globals (Param, Technology), so the evaluations are serialized
+ * by a lock, and the GIL is released while a design is evaluated so that the other Python threads keep running */
+
+static unique_ptr<SimServer> simServer;
+static mutex simMutex;
+static PyObject *DesignErrorType = NULL;
+static PyObject *numpyAsarray = NULL;   // numpy.asarray (NULL: numpy not installed, lists are returned)
+
+static void initializeServer() {
+    simServer.reset(new SimServer(inputParameter, tech, cell));
+    simServer->Initialize(param->synapseBit, param->numBitInput, 1);
+}
+
+/* Python -> C++ */
+static bool toIntVector2(PyObject *obj, vector<vector<int>> *values) {
+    PyObject *rows = PySequence_Fast(obj, "design_params should be a sequence of rows");
+    if ( rows == NULL ) {
+        return false;
+    }
+    for ( Py_ssize_t i=0; i < PySequence_Fast_GET_SIZE(rows); i++ ) {
+        PyObject *row = PySequence_Fast(PySequence_Fast_GET_ITEM(rows, i), "a row of design_params should be a sequence");
+        if ( row == NULL ) {
+            Py_DECREF(rows);
+            return false;
+        }
+        vector<int> rowValues;
+        for ( Py_ssize_t j=0; j < PySequence_Fast_GET_SIZE(row); j++ ) {
+            long value = PyLong_AsLong(PySequence_Fast_GET_ITEM(row, j));
+            if ( (value == -1) && PyErr_Occurred() ) {
+                Py_DECREF(row);
+                Py_DECREF(rows);
+                return false;
+            }
+            rowValues.push_back((int)value);
+        }
+        values->push_back(rowValues);
+        Py_DECREF(row);
+    }
+    Py_DECREF(rows);
+    return true;
+}
+
+/* C++ -> Python (numpy arrays when numpy is installed) */
+static PyObject* toArray(PyObject *list) {
+    if ( (list == NULL) || (numpyAsarray == NULL) ) {
+        return list;
+    }
+    PyObject *array = PyObject_CallFunctionObjArgs(numpyAsarray, list, NULL);
+    Py_DECREF(list);
+    return array;
+}
+
+template <typename T>
+static PyObject* toList(const vector<T> &values) {
+    PyObject *list = PyList_New(values.size());
+    for ( size_t i=0; (list != NULL) && (i < values.size()); i++ ) {
+        PyList_SET_ITEM(list, i, PyFloat_FromDouble((double)values[i]));
+    }
+    return list;
+}
+
+template <typename T>
+static PyObject* toList2(const vector<vector<T>> &values) {
+    PyObject *list = PyList_New(values.size());
+    for ( size_t i=0; (list != NULL) && (i < values.size()); i++ ) {
+        PyList_SET_ITEM(list, i, toList(values[i]));
+    }
+    return list;
+}
+
+static PyObject* toIntList2(const vector<vector<int>> &values) {
+    PyObject *list = PyList_New(values.size());
+    for ( size_t i=0; (list != NULL) && (i < values.size()); i++ ) {
+        PyObject *row = PyList_New(values[i].size());
+        for ( size_t j=0; (row != NULL) && (j < values[i].size()); j++ ) {
+            PyList_SET_ITEM(row, j, PyLong_FromLong(values[i][j]));
+        }
+        PyList_SET_ITEM(list, i, row);
+    }
+    return list;
+}
+
+// dict[key] = value (reference of value stolen)
+static void setItem(PyObject *dict, const char *key, PyObject *value) {
+    if ( value != NULL ) {
+        PyDict_SetItemString(dict, key, value);
+        Py_DECREF(value);
+    }
+}
+
+static PyObject* toDict(const ServerResult &result) {
+    PyObject *dict = PyDict_New();
+    setItem(dict, "area", PyFloat_FromDouble(result.area));
+    setItem(dict, "energy", PyFloat_FromDouble(result.energy));
+    setItem(dict, "latency", PyFloat_FromDouble(result.latency));
+    setItem(dict, "power", PyFloat_FromDouble(result.power));
+    setItem(dict, "topsw", PyFloat_FromDouble(result.topsw));
+    setItem(dict, "tops", PyFloat_FromDouble(result.tops));
+    setItem(dict, "clkPeriod", PyFloat_FromDouble(result.clkPeriod));
+    setItem(dict, "designArch", toIntList2(result.designArch));
+
+    // breakdowns (chip: total, array, ADC, accum, buffer, ic, other / hObj: total, subObject, accum, buffer, ic, other)
+    setItem(dict, "chipArea", toArray(toList(result.chipAreaVector)));
+    setItem(dict, "chipLatency", toArray(toList(result.chipLatencyVector)));
+    setItem(dict, "chipEnergy", toArray(toList(result.chipEnergyVector)));
+    setItem(dict, "areaBreakdown", toArray(toList2(result.areaVector2)));
+    setItem(dict, "latencyBreakdown", toArray(toList2(result.latencyVector2)));
+    setItem(dict, "energyBreakdown", toArray(toList2(result.energyVector2)));
+
+    PyObject *networks = PyList_New(0);
+    for ( size_t networkIdx=0; networkIdx < result.networkNames.size(); networkIdx++ ) {
+        const vector<double> &metric = result.networkMetric[networkIdx];
+        PyObject *network = PyDict_New();
+        setItem(network, "name", PyUnicode_FromString(result.networkNames[networkIdx].c_str()));
+        setItem(network, "energy", PyFloat_FromDouble(metric[0]));
+        setItem(network, "latency", PyFloat_FromDouble(metric[1]));
+        setItem(network, "topsw", PyFloat_FromDouble(metric[2]));
+        setItem(network, "tops", PyFloat_FromDouble(metric[3]));
+        PyList_Append(networks, network);
+        Py_DECREF(network);
+    }
+    setItem(dict, "networks", networks);
+
+    PyObject *cacheUsed = PyDict_New();
+    setItem(cacheUsed, "result", PyBool_FromLong(result.resultHit));
+    setItem(cacheUsed, "root", PyBool_FromLong(result.rootHit));
+    setItem(cacheUsed, "shared", PyLong_FromLong(result.numShared));
+    setItem(dict, "cache", cacheUsed);
+    return dict;
+}
+
+static PyObject* evaluate(PyObject *self, PyObject *args, PyObject *kwargs) {
+    static const char *keywords[] = {"design_params", "network", "wbits", "abits", "scheduler_type", "array", "cache", NULL};
+    PyObject *designParamObj;
+    const char *network;
+    int synapseBit, numBitInput, scheduler_type = 1;
+    PyObject *arrayObj = Py_None;
+    int cache = 1;
+    if ( !PyArg_ParseTupleAndKeywords(args, kwargs, "Osii|iOp", (char**)keywords, &designParamObj, &network,
+                                      &synapseBit, &numBitInput, &scheduler_type, &arrayObj, &cache) ) {
+        return NULL;
+    }
+
+    // design params: rows of (row, col, outType, outBW, inType, inBW, buType, outCoreBW, inCoreBW) or a csv file
+    vector<vector<int>> designParam;
+    if ( PyUnicode_Check(designParamObj) ) {
+        string filename = PyUnicode_AsUTF8(designParamObj);
+        if ( !ifstream(filename.c_str()).good() ) {
+            PyErr_Format(PyExc_FileNotFoundError, "design params %s cannot be opened", filename.c_str());
+            return NULL;
+        }
+        designParam = readCSVint(filename);
+    } else if ( !toIntVector2(designParamObj, &designParam) ) {
+        return NULL;
+    }
+    vector<int> arrayParam = simServer->arrayParam;
+    if ( arrayObj != Py_None ) {
+        vector<vector<int>> arrayValues;
+        PyObject *rows = PyTuple_Pack(1, arrayObj);
+        bool valid = toIntVector2(rows, &arrayValues);
+        Py_DECREF(rows);
+        if ( !valid ) {
+            return NULL;
+        }
+        arrayParam = arrayValues[0];
+    }
+    for ( auto &designHObj : designParam ) {
+        if ( designHObj.size() != 9 ) {
+            PyErr_SetString(PyExc_ValueError, "design_params rows need 9 values (row, col, outType, outBW, inType, inBW, buType, outCoreBW, inCoreBW)");
+            return NULL;
+        }
+    }
+    if ( designParam.empty() || (arrayParam.size() != 4) || (arrayParam[0] < 1) || (arrayParam[1] < 1) || (arrayParam[2] < 2)
+         || (arrayParam[3] < 1) || (synapseBit < 1) || (numBitInput < 1) || ((scheduler_type != 0) && (scheduler_type != 1)) ) {
+        PyErr_SetString(PyExc_ValueError, "invalid design_params, array (numRowCIMArray, numColCIMArray, levelOutput >= 2, numColMuxed), "
+                                          "precision or scheduler_type (0: base, 1: compact mapping)");
+        return NULL;
+    }
+
+    ServerResult result;
+    string networkList = network;
+    string reason, message;
+    bool designError = false, requestError = false;
+    Py_BEGIN_ALLOW_THREADS
+    {
+        lock_guard<mutex> lock(simMutex);
+        try {
+            result = simServer->EvaluateDesign(networkList, synapseBit, numBitInput, scheduler_type, arrayParam, designParam, cache);
+        } catch ( const DesignError &e ) {
+            designError = true;
+            reason = e.reason;
+            message = e.what();
+        } catch ( const exception &e ) {
+            requestError = true;
+            message = e.what();
+        }
+        fflush(stdout);
+    }
+    Py_END_ALLOW_THREADS
+
+    if ( designError ) {
+        // DesignError(reason, message): the reason code of the batch DSE
+        PyObject *error = PyObject_CallFunction(DesignErrorType, "ss", reason.c_str(), message.c_str());
+        if ( error != NULL ) {
+            PyErr_SetObject(DesignErrorType, error);
+            Py_DECREF(error);
+        }
+        return NULL;
+    } else if ( requestError ) {
+        PyErr_SetString(PyExc_ValueError, message.c_str());
+        return NULL;
+    }
+    return toDict(result);
+}
+
+static PyObject* set_param(PyObject *self, PyObject *args) {
+    const char *name;
+    double value;
+    if ( !PyArg_ParseTuple(args, "sd", &name, &value) ) {
+        return NULL;
+    }
+    bool valid;
+    // simMutex is taken without the GIL, so an evaluation holding it does not block the other Python threads
+    Py_BEGIN_ALLOW_THREADS
+    {
+        lock_guard<mutex> lock(simMutex);
+        // Param as before the evaluations, then the override (the caches are built again)
+        param->clkFreq = simServer->clkFreq;
+        param->cellBit = simServer->cellBit;
+        param->numRowCIMArray = simServer->arrayParam[0];
+        param->numColCIMArray = simServer->arrayParam[1];
+        param->levelOutput = simServer->arrayParam[2];
+        param->numColMuxed = simServer->arrayParam[3];
+        valid = param->SetParam(name, value);
+        if ( valid ) {
+            initializeServer();
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if ( !valid ) {
+        PyErr_Format(PyExc_ValueError, "invalid parameter %s=%g", name, value);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* stats(PyObject *self, PyObject *args) {
+    string text;
+    Py_BEGIN_ALLOW_THREADS
+    {
+        lock_guard<mutex> lock(simMutex);
+        text = simServer->Stats().Dump();
+    }
+    Py_END_ALLOW_THREADS
+    PyObject *json = PyImport_ImportModule("json");
+    if ( json == NULL ) {
+        return NULL;
+    }
+    PyObject *dict = PyObject_CallMethod(json, "loads", "s", text.c_str());
+    Py_DECREF(json);
+    return dict;
+}
+
+static PyMethodDef sageMethods[] = {
+    {"evaluate", (PyCFunction)(void(*)(void))evaluate, METH_VARARGS | METH_KEYWORDS,
+     "evaluate(design_params, network, wbits, abits, scheduler_type=1, array=None, cache=True)\n"
+     "design_params: rows of (row, col, outType, outBW, inType, inBW, buType, outCoreBW, inCoreBW) or a csv file,\n"
+     "network: network file or portfolio (file[:weight],...), array: (numRowCIMArray, numColCIMArray, levelOutput, numColMuxed).\n"
+     "Returns a dict of area [m^2], energy [J], latency [s], power [W], topsw, tops, the designArch, the chip breakdowns\n"
+     "(chipArea/chipLatency/chipEnergy) & per-hierarchy breakdowns (areaBreakdown/latencyBreakdown/energyBreakdown) as\n"
+     "numpy arrays (lists without numpy), and the metrics of each network. Raises DesignError(reason, message) for an invalid design.\n"
+     "The GIL is released during the evaluation, the evaluations themselves run one at a time (process-wide Param)."},
+    {"set_param", set_param, METH_VARARGS,
+     "set_param(name, value): parameter override of Param (name=value of main), applied to the next evaluations"},
+    {"stats", stats, METH_NOARGS, "stats(): requests & cache statistics of the evaluator"},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef sageModule = {
+    PyModuleDef_HEAD_INIT, "sage_imc", "In-process evaluator of SAGE IMC designs (see evaluate)", -1, sageMethods
+};
+
+PyMODINIT_FUNC PyInit_sage_imc(void) {
+    PyObject *module = PyModule_Create(&sageModule);
+    if ( module == NULL ) {
+        return NULL;
+    }
+    DesignErrorType = PyErr_NewExceptionWithDoc("sage_imc.DesignError",
+                                                "invalid design, args: (reason code, message)", PyExc_ValueError, NULL);
+    Py_XINCREF(DesignErrorType);
+    if ( PyModule_AddObject(module, "DesignError", DesignErrorType) < 0 ) {
+        Py_XDECREF(DesignErrorType);
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    PyObject *numpy = PyImport_ImportModule("numpy");
+    if ( numpy != NULL ) {
+        numpyAsarray = PyObject_GetAttrString(numpy, "asarray");
+        Py_DECREF(numpy);
+    }
+    PyErr_Clear();
+
+    gen.seed(0);
+    param->synapseBit = 8;
+    param->numBitInput = 8;
+    initializeServer();
+    return module;
+}
@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <random>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <vector>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "constant.h"
+#include "formula.h"
+#include "HierarchyRoot.h"
+#include "Param.h"
+#include "Definition.h"
+#include "util.h"
+#include "SimServer.h"
+#include "DesignError.h"
+
+using namespace std;
+
+/* write a response line (false if the client is gone) */
+static bool writeLine(int fd, const string &line) {
+    string data = line + "\n";
+    size_t offset = 0;
+    while ( offset < data.size() ) {
+        ssize_t numWritten = write(fd, data.c_str() + offset, data.size() - offset);
+        if ( numWritten <= 0 ) {
+            return false;
+        }
+        offset += numWritten;
+    }
+    return true;
+}
+
+/* answer the request lines of a connection until EOF or shutdown */
+static void serve(SimServer &simServer, int inFd, int outFd) {
+    string buffer;
+    char chunk[65536];
+    while ( !simServer.shutdown ) {
+        size_t newline = buffer.find('\n');
+        if ( newline == string::npos ) {
+            ssize_t numRead = read(inFd, chunk, sizeof(chunk));
+            if ( numRead <= 0 ) {
+                break;
+            }
+            buffer.append(chunk, numRead);
+            continue;
+        }
+        string line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+        if ( line.find_first_not_of(" \t\r") == string::npos ) {
+            continue;
+        }
+        string response = simServer.HandleRequest(line);
+        fflush(stdout);
+        if ( !writeLine(outFd, response) ) {
+            break;
+        }
+    }
+}
+
+/* Simulation server: technology, CIM arrays & hierarchy subtrees stay initialized across the requests
+ * line-delimited JSON requests on stdin (responses on stdout, simulator log on stderr) or on a Unix domain socket
+ * usage: sage_server wbits abits scheduler_type [--socket path] [name=value ...] */
+int main(int argc, char * argv[]) try {
+
+    gen.seed(0);
+
+    if ( argc < 4 ) {
+        cerr << "usage: sage_server wbits abits scheduler_type [--socket path] [name=value ...]" << endl;
+        return -1;
+    }
+    int synapseBit = atoi(argv[1]);     // default precision of synapse weight
+    int numBitInput = atoi(argv[2]);    // default precision of input neural activation
+    int scheduler_type = atoi(argv[3]);
+    string socketPath;
+    int firstParamArg = 4;
+    if ( (argc > 5) && (string(argv[4]) == "--socket") ) {
+        socketPath = argv[5];
+        firstParamArg = 6;
+    }
+
+    // optional parameter overrides (name=value), shared by every request
+    param->ReadParamArgs(argc, argv, firstParamArg);
+    signal(SIGPIPE, SIG_IGN);
+
+    SimServer simServer(inputParameter, tech, cell);
+    simServer.Initialize(synapseBit, numBitInput, scheduler_type);
+
+    if ( socketPath.empty() ) {
+        // responses on the original stdout, the prints of the simulator go to stderr
+        int outFd = dup(STDOUT_FILENO);
+        fflush(stdout);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        serve(simServer, STDIN_FILENO, outFd);
+        close(outFd);
+        return 0;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if ( socketPath.size() >= sizeof(addr.sun_path) ) {
+        cerr << "[Error] socket path is too long: " << socketPath << endl;
+        exit(-1);
+    }
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    int serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if ( (serverFd < 0) || (bind(serverFd, (struct sockaddr*)&addr, sizeof(addr)) != 0) || (listen(serverFd, 8) != 0) ) {
+        cerr << "[Error] cannot listen on " << socketPath << ": " << strerror(errno) << endl;
+        exit(-1);
+    }
+    printf("sage_server listening on %s\n", socketPath.c_str());
+    fflush(stdout);
+
+    // clients served in turn (the caches are shared by the connections)
+    while ( !simServer.shutdown ) {
+        int clientFd = accept(serverFd, NULL, NULL);
+        if ( clientFd < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            cerr << "[Error] accept failed: " << strerror(errno) << endl;
+            break;
+        }
+        serve(simServer, clientFd, clientFd);
+        close(clientFd);
+    }
+    close(serverFd);
+    unlink(socketPath.c_str());
+
+} catch ( const DesignError &e ) {
+    // the requests answer invalid designs, so this is an error of the server setup
+    cerr << "[Error] " << e.what() << endl;
+    return -1;
+}
@@ -15,18 +15,45 @@ def read_arguments():
     parser.add_argument('--netfile', default='Network_VGG8.csv', type=str)
     parser.add_argument('--basefolder', default='Network_VGG8_Simul', type=str)
     parser.add_argument('--max-numHierarchy', default=3, type=int)
-    parser.add_argument('--numRowCIMArray', default=128, type=int)
-    parser.add_argument('--numColCIMArray', default=128, type=int)
+    # CIM array params (comma-separated values are swept)
+    parser.add_argument('--numRowCIMArray', default='128', type=str)
+    parser.add_argument('--numColCIMArray', default='128', type=str)
+    parser.add_argument('--levelOutput', default='16', type=str)
+    parser.add_argument('--numColMuxed', default='1', type=str)
     parser.add_argument('-w', '--wbits', default=4, type=int)
     parser.add_argument('-a', '--abits', default=4, type=int)
     parser.add_argument('--cellBit', default=2, type=int)
     parser.add_argument('--numCellPerSynpase', default=2, type=int)
     parser.add_argument('--compact-mapping', default=1, type=int)
+    parser.add_argument('--params', default='', type=str) # parameter overrides (e.g. "pingPongBuffer=1")
+    parser.add_argument('--batch', action='store_true')   # run the whole sweep in a single main_dse process
+    # constraints of the batch DSE (0: none), designs are pruned with bounds before scheduling
+    parser.add_argument('--maxArea', default=0, type=float)    # mm^2
+    parser.add_argument('--minTOPS', default=0, type=float)
+    parser.add_argument('--maxPower', default=0, type=float)   # W
+    parser.add_argument('--pruneDominated', action='store_true')
+    parser.add_argument('--saveAll', action='store_true')  # full breakdowns of every design (default: Pareto front only)
+    parser.add_argument('--checkpointInterval', default=100, type=int) # designs between checkpoints of the batch DSE
+    parser.add_argument('--resume', action='store_true')   # resume the batch DSE from the journal of the basefolder
+    parser.add_argument('--numWorker', default=0, type=int) # local worker processes of the batch DSE
+    # NSGA-II search of the batch DSE instead of the exhaustive sweep (population 0: exhaustive)
+    parser.add_argument('--population', default=0, type=int)
+    parser.add_argument('--generation', default=20, type=int)
+    parser.add_argument('--seed', default=0, type=int)
+    parser.add_argument('--surrogate', action='store_true')    # screen the offspring with a Gaussian-process surrogate
+    # IC & BU knobs of each hierarchy searched (comma-separated, empty: fixed by the IC/BU design params)
+    parser.add_argument('--outType', default='', type=str)
+    parser.add_argument('--inType', default='', type=str)
+    parser.add_argument('--busWidth', default='', type=str)
+    parser.add_argument('--buType', default='', type=str)
+    parser.add_argument('--coreBW', default='', type=str)
     args = parser.parse_args()
 
     args.numCellPerSynapse = math.ceil( args.wbits / args.cellBit )
-    args.netfile = args.net + '.csv' 
-    args.basefolder = args.net + '_Simul' 
+    # network portfolio (comma-separated networks with optional weights, net[:weight])
+    nets = [net.split(':') for net in args.net.split(',')]
+    args.netfile = ','.join([net[0] + '.csv' + ''.join(':' + w for w in net[1:]) for net in nets])
+    args.basefolder = '_'.join([net[0] for net in nets]) + '_Simul' 
 
     print("----------args----------")
     print(args)
@@ -39,11 +66,11 @@ def scanNumHierarchy(args):
     designParams_ic_bu = [3, 128, 3, 128, 0, 128, 128]
     designParams_ic_bu_top = [3, 128, 3, 128, 1, 128, 0]
 
-    # make basefolder (folder for gathering simulation data)
-    if os.path.exists(args.basefolder):
+    # make basefolder (folder for gathering simulation data), kept for a resumed batch DSE
+    if os.path.exists(args.basefolder) and not (args.batch and args.resume):
         print(f"remove folder {args.basefolder}")
         os.system(f"rm -rf {args.basefolder}")
-    os.makedirs(args.basefolder)
+    os.makedirs(args.basefolder, exist_ok=True)
 
     # make folders to categorize data
     designParam_folder = os.path.join(args.basefolder, "designParam")
@@ -51,45 +78,86 @@ def scanNumHierarchy(args):
     performanceChip_folder = os.path.join(args.basefolder, "performanceChip")
     performanceHObj_folder = os.path.join(args.basefolder, "performanceHObj")
 
-    os.makedirs(designParam_folder)
-    os.makedirs(designArch_folder)
-    os.makedirs(performanceChip_folder)
-    os.makedirs(performanceHObj_folder)
+    os.makedirs(designParam_folder, exist_ok=True)
+    os.makedirs(designArch_folder, exist_ok=True)
+    os.makedirs(performanceChip_folder, exist_ok=True)
+    os.makedirs(performanceHObj_folder, exist_ok=True)
+
+    # CIM array sweep
+    array_list = [ [numRow, numCol, levelOutput, numColMuxed]
+                    for numRow in args.numRowCIMArray.split(',')
+                    for numCol in args.numColCIMArray.split(',')
+                    for levelOutput in args.levelOutput.split(',')
+                    for numColMuxed in args.numColMuxed.split(',') ]
+
+    if args.batch:
+        # in-process batch DSE (CIM arrays are built once and shared by the hierarchy designs)
+        filename_dseConfig = os.path.join(args.basefolder, "dseConfig.csv")
+        with open(filename_dseConfig, "w", newline="") as f:
+            writer = csv.writer(f)
+            writer.writerow(["maxNumHierarchy", args.max_numHierarchy])
+            writer.writerow(["numRowCIMArray"] + args.numRowCIMArray.split(','))
+            writer.writerow(["numColCIMArray"] + args.numColCIMArray.split(','))
+            writer.writerow(["levelOutput"] + args.levelOutput.split(','))
+            writer.writerow(["numColMuxed"] + args.numColMuxed.split(','))
+            writer.writerow(["designParamICBU"] + designParams_ic_bu)
+            writer.writerow(["designParamICBUTop"] + designParams_ic_bu_top)
+            writer.writerow(["maxArea", args.maxArea])
+            writer.writerow(["minTOPS", args.minTOPS])
+            writer.writerow(["maxPower", args.maxPower])
+            writer.writerow(["pruneDominated", int(args.pruneDominated)])
+            writer.writerow(["saveAll", int(args.saveAll)])
+            writer.writerow(["checkpointInterval", args.checkpointInterval])
+            writer.writerow(["numWorker", args.numWorker])
+            if args.population > 0:
+                writer.writerow(["searchPopulation", args.population])
+                writer.writerow(["searchGeneration", args.generation])
+                writer.writerow(["searchSeed", args.seed])
+                writer.writerow(["searchSurrogate", int(args.surrogate)])
+                for knob in ["outType", "inType", "busWidth", "buType", "coreBW"]:
+                    if getattr(args, knob):
+                        writer.writerow([knob] + getattr(args, knob).split(','))
+        print(f"./main_dse {filename_dseConfig} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {args.basefolder} {args.params}")
+        os.system(f"./main_dse {filename_dseConfig} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {args.basefolder} {args.params}")
+        return
 
     design_counter = 0
 
-    # simulate different architectures
-    for num_hierarchy in range(1, args.max_numHierarchy+1):
-        # get arch design params (variable: numSubObjects)
-        numHObj_list = get_numSubObject_list(num_hierarchy)
-        num_design = len(numHObj_list)
-
-        for designIdx in range(0, num_design):
-            # get design 
-            numHObj = numHObj_list[designIdx]
-
-            # generate designParams
-            designParams = []
-            for hIdx in range(0, num_hierarchy-1):
-                designParams_hObj = numHObj[hIdx] + designParams_ic_bu
-                designParams.append(designParams_hObj)
-            designParams.append(numHObj[num_hierarchy-1] + designParams_ic_bu_top)
-            # save designParams as designParams.csv file
-            filename_designParam = os.path.join(designParam_folder, "designParam_{}.csv".format(design_counter))
-            with open(filename_designParam, "w", newline="") as f:
-                writer = csv.writer(f)
-                writer.writerows(designParams)
-
-            # generate architecture with design Params
-            filename_designArch = os.path.join(designArch_folder, "designArch_{}.csv".format(design_counter))
-            print(f"./arch_generator_for_net {filename_designParam} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {filename_designArch}")
-            os.system(f"./arch_generator_for_net {filename_designParam} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {filename_designArch}")
-
-            # do the simulation with generatred architecture
-            print(f"./main_iter {filename_designArch} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {design_counter} {args.basefolder}")
-            os.system(f"./main_iter {filename_designArch} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {design_counter} {args.basefolder}")
+    for numRow, numCol, levelOutput, numColMuxed in array_list:
+        params = f"numRowCIMArray={numRow} numColCIMArray={numCol} levelOutput={levelOutput} numColMuxed={numColMuxed} {args.params}"
+
+        # simulate different architectures
+        for num_hierarchy in range(1, args.max_numHierarchy+1):
+            # get arch design params (variable: numSubObjects)
+            numHObj_list = get_numSubObject_list(num_hierarchy)
+            num_design = len(numHObj_list)
+
+            for designIdx in range(0, num_design):
+                # get design 
+                numHObj = numHObj_list[designIdx]
+
+                # generate designParams
+                designParams = []
+                for hIdx in range(0, num_hierarchy-1):
+                    designParams_hObj = numHObj[hIdx] + designParams_ic_bu
+                    designParams.append(designParams_hObj)
+                designParams.append(numHObj[num_hierarchy-1] + designParams_ic_bu_top)
+                # save designParams as designParams.csv file
+                filename_designParam = os.path.join(designParam_folder, "designParam_{}.csv".format(design_counter))
+                with open(filename_designParam, "w", newline="") as f:
+                    writer = csv.writer(f)
+                    writer.writerows(designParams)
+
+                # generate architecture with design Params
+                filename_designArch = os.path.join(designArch_folder, "designArch_{}.csv".format(design_counter))
+                print(f"./arch_generator_for_net {filename_designParam} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {filename_designArch} {params}")
+                os.system(f"./arch_generator_for_net {filename_designParam} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {filename_designArch} {params}")
+
+                # do the simulation with generatred architecture
+                print(f"./main_iter {filename_designArch} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {design_counter} {args.basefolder} {params}")
+                os.system(f"./main_iter {filename_designArch} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {design_counter} {args.basefolder} {params}")
             
-            design_counter += 1
+                design_counter += 1
 
 def get_numSubObject_list(num_hierarchy):
     # get arch design params (variable: numSubObjects)
@@ -102,7 +170,7 @@ def get_numSubObject_list(num_hierarchy):
         h_numHObj_list = numHObj_list
         numHObj_list = []
         for numSubObjectRow in list_numSubObjectRow:
-            for numSubObjectCol in list_numSubObjectRow:
+            for numSubObjectCol in list_numSubObjectCol:
                 if not ((numSubObjectRow == 1) & (numSubObjectCol ==1)):
                     # get numSubObject design
                     numSubObject = [numSubObjectRow, numSubObjectCol]
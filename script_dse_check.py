@@ -0,0 +1,128 @@
+import argparse
+import os
+import csv
+import shutil
+import subprocess
+import sys
+from script_regression import compare_rows
+
+# Checks of the batch DSE (main_dse) on a small design space (regression/dseConfig.csv).
+# golden: designs.csv and pareto.csv of a run in process and of a run on worker processes
+#         against regression/golden/dse.
+# resume: the journal of a complete run is cut in the middle of a record, and the resumed run
+#         must give the designs.csv and pareto.csv of the uninterrupted run.
+
+def read_arguments():
+    parser = argparse.ArgumentParser(
+                description = 'check the batch DSE on a small design space')
+
+    parser.add_argument('--bindir', default='.', type=str)
+    parser.add_argument('--casedir', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), 'regression'), type=str)
+    parser.add_argument('--workdir', default='dse_work', type=str)
+    parser.add_argument('--config', default='dseConfig.csv', type=str)   # in the casedir
+    parser.add_argument('--network', default='../Network_VGG8.csv', type=str)   # relative to the casedir
+    parser.add_argument('--params', default='', type=str)   # parameter overrides of main_dse (space-separated name=value)
+    parser.add_argument('--numWorker', default=2, type=int)  # worker processes of the second golden run
+    parser.add_argument('--rtol', default=1e-3, type=float)
+    parser.add_argument('--update', action='store_true')     # regenerate the golden outputs
+    args = parser.parse_args()
+
+    args.bindir = os.path.abspath(args.bindir)
+    args.casedir = os.path.abspath(args.casedir)
+    args.workdir = os.path.abspath(args.workdir)
+
+    return args
+
+def run_dse(args, basefolder, config=None):
+    cmd = [os.path.join(args.bindir, 'main_dse'), config or os.path.join(args.casedir, args.config),
+           os.path.join(args.casedir, args.network), '4', '4', '1', basefolder] + args.params.split()
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    return proc.stdout.decode(errors='replace'), proc.returncode
+
+def read_sorted(filename):
+    # rows in archIdx order (the worker processes complete the designs in any order)
+    with open(filename, newline='') as f:
+        rows = list(csv.reader(f))
+    return rows[:1] + sorted(rows[1:], key=lambda row: int(row[0]))
+
+def compare_outputs(folder, goldenFolder, rtol):
+    errors = []
+    for filename in ['designs.csv', 'pareto.csv']:
+        goldenFile = os.path.join(goldenFolder, filename)
+        if not os.path.exists(goldenFile):
+            errors.append(f"{filename}: missing golden file")
+            continue
+        errors += compare_rows(filename, read_sorted(goldenFile), read_sorted(os.path.join(folder, filename)), rtol, 1e-30)
+    return errors
+
+def check(name, errors):
+    print(f"[{'FAIL' if errors else 'PASS':>7}] {name}")
+    for error in errors[:20]:
+        print(f"          {error}")
+    if len(errors) > 20:
+        print(f"          ... {len(errors)-20} more mismatches")
+    return len(errors)
+
+def check_resume(args):
+    full = os.path.join(args.workdir, 'full')
+    stdout, ret = run_dse(args, full)
+    if ret != 0:
+        return check('resume', [f"main_dse exited with {ret}", stdout[-500:]])
+
+    # journal of an interrupted run: header, half of the records and a partial record
+    resumed = os.path.join(args.workdir, 'resumed')
+    os.makedirs(resumed)
+    with open(os.path.join(full, 'journal.csv')) as f:
+        lines = f.readlines()
+    numKeep = 1 + (len(lines) - 1) // 2
+    with open(os.path.join(resumed, 'journal.csv'), 'w') as f:
+        f.writelines(lines[:numKeep])
+        f.write(lines[numKeep][:len(lines[numKeep]) // 2])
+
+    stdout, ret = run_dse(args, resumed)
+    if ret != 0:
+        return check('resume', [f"resumed main_dse exited with {ret}", stdout[-500:]])
+    errors = compare_outputs(resumed, full, 0)
+    if 'resume with' not in stdout:
+        errors.append('resume: the journal was not replayed')
+
+    # a journal of other run settings is refused
+    stdout, ret = run_dse(argparse.Namespace(**{**vars(args), 'params': args.params + ' pipeline=1'}), resumed)
+    if ret == 0:
+        errors.append('resume: the journal of other parameter overrides was accepted')
+
+    return check(f'resume ({numKeep-1} of {len(lines)-1} designs in the journal)', errors)
+
+def check_golden(args):
+    goldenFolder = os.path.join(args.casedir, 'golden', 'dse')
+    with open(os.path.join(args.casedir, args.config)) as f:
+        config = [line for line in f.read().splitlines() if not line.startswith('numWorker')]
+    numFail = 0
+    for numWorker in [0, args.numWorker]:
+        name = f'golden (numWorker {numWorker})'
+        basefolder = os.path.join(args.workdir, f'golden_{numWorker}')
+        os.makedirs(basefolder)
+        configFile = os.path.join(basefolder, 'dseConfig.csv')
+        with open(configFile, 'w') as f:
+            f.write('\n'.join(config + [f'numWorker,{numWorker}']) + '\n')
+        stdout, ret = run_dse(args, basefolder, configFile)
+        if ret != 0:
+            numFail += check(name, [f"main_dse exited with {ret}", stdout[-500:]])
+        elif args.update:
+            os.makedirs(goldenFolder, exist_ok=True)
+            for filename in ['designs.csv', 'pareto.csv']:
+                shutil.copyfile(os.path.join(basefolder, filename), os.path.join(goldenFolder, filename))
+            print(f"[UPDATED] {name}")
+            break
+        else:
+            numFail += check(name, compare_outputs(basefolder, goldenFolder, args.rtol))
+    return numFail
+
+if __name__ == '__main__':
+    args = read_arguments()
+    if os.path.exists(args.workdir):
+        shutil.rmtree(args.workdir)
+    os.makedirs(args.workdir)
+    numFail = check_golden(args)
+    numFail += 0 if args.update else check_resume(args)
+    sys.exit(1 if numFail > 0 else 0)
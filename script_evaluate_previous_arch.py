@@ -6,6 +6,7 @@ import pandas as pd
 #import matplotlib.pyplot as plt
 #import seaborn as sns
 import numpy as np
+import sys
 
 def read_arguments():
     parser = argparse.ArgumentParser(
@@ -22,6 +23,8 @@ def read_arguments():
     parser.add_argument('--cellBit', default=2, type=int)
     parser.add_argument('--numCellPerSynpase', default=2, type=int)
     parser.add_argument('--compact-mapping', default=1, type=int)
+    parser.add_argument('--module', action='store_true') # evaluate in process with the sage_imc module (summary.csv)
+    parser.add_argument('--bindir', default='.', type=str)  # folder of the sage_imc module
     args = parser.parse_args()
 
     args.numCellPerSynapse = math.ceil( args.wbits / args.cellBit )
@@ -48,7 +51,7 @@ def testConventionalArch(args):
                              [8, 1, 3, 128, 3, 128, 0, 128, 128], 
                              [1000, 1000, 3, 128, 3, 128, 1, 128, 0]]
     designParams_list = [designParams_NeuroSim, designParams_ISAAC, designParams_PIMCA,
-                         designParams_PUMA, designParams_CMP]
+                         designParams_PUMA]
 
     # make basefolder (folder for gathering simulation data)
     if os.path.exists(args.basefolder):
@@ -68,6 +71,10 @@ def testConventionalArch(args):
     os.makedirs(performanceHObj_folder)
 
     design_counter = 0
+    if args.module:
+        sys.path.insert(0, os.path.abspath(args.bindir))
+        import sage_imc
+        summary = [["archIdx", "area(mm^2)", "energy_with_leakage(pJ)", "latency(ns)", "topsw", "tops"]]
 
     # simulate different architectures
     # get arch design params (variable: numSubObjects)
@@ -82,6 +89,17 @@ def testConventionalArch(args):
             writer = csv.writer(f)
             writer.writerows(designParams)
 
+        # generate & simulate in process (no program runs, metrics returned directly)
+        if args.module:
+            result = sage_imc.evaluate(designParams, args.netfile, args.wbits, args.abits, args.compact_mapping)
+            with open(os.path.join(designArch_folder, "designArch_{}.csv".format(design_counter)), "w", newline="") as f:
+                csv.writer(f).writerows(result['designArch'])
+            summary.append([design_counter, result['area']*1e6, result['energy']*1e12, result['latency']*1e9,
+                            result['topsw'], result['tops']])
+            print(f"design {design_counter}: {result['topsw']:.4f} TOPS/W {result['tops']:.4f} TOPS")
+            design_counter += 1
+            continue
+
         # generate architecture with design Params
         filename_designArch = os.path.join(designArch_folder, "designArch_{}.csv".format(design_counter))
         print(f"./arch_generator_for_net {filename_designParam} {args.netfile} {args.wbits} {args.abits} {args.compact_mapping} {filename_designArch}")
@@ -93,6 +111,10 @@ def testConventionalArch(args):
         
         design_counter += 1
 
+    if args.module:
+        with open(os.path.join(args.basefolder, "summary.csv"), "w", newline="") as f:
+            csv.writer(f).writerows(summary)
+
 if __name__ == '__main__':
     args = read_arguments()
     testConventionalArch(args)
@@ -0,0 +1,75 @@
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+# Peak memory of the scheduling on a synthetic ResNet-scale network (65 layers),
+# where the schedule records dominate the footprint of arch_generator_for_net and main.
+# The peak RSS is the one printed by the program (VmHWM), or VmHWM polled from /proc
+# for builds that do not print it, so that older builds can be measured the same way.
+
+def read_arguments():
+    parser = argparse.ArgumentParser(
+                description = 'measure the peak RSS of the scheduling on a synthetic ResNet-scale network')
+
+    parser.add_argument('--bindir', default='.', type=str)
+    parser.add_argument('--designParam', default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                              'regression', 'designParam_NeuroSim.csv'), type=str)
+    parser.add_argument('--workdir', default='memory_work', type=str)
+    parser.add_argument('-w', '--wbits', default=8, type=int)
+    parser.add_argument('-a', '--abits', default=8, type=int)
+    args = parser.parse_args()
+
+    args.bindir = os.path.abspath(args.bindir)
+    args.designParam = os.path.abspath(args.designParam)
+    args.workdir = os.path.abspath(args.workdir)
+
+    return args
+
+def write_network(filename):
+    # 3x3 conv stages of a ResNet on 224x224 inputs, then the classifier
+    rows = []
+    for size, channel, numLayer in [(56, 256, 16), (28, 512, 16), (14, 1024, 24), (7, 2048, 8)]:
+        rows += [f"{size},{size},{channel},3,3,{channel},0,1,1"] * numLayer
+    rows.append("1,1,2048,1,1,1000,0,0,1")
+    with open(filename, 'w') as f:
+        f.write('\n'.join(rows) + '\n')
+    return len(rows)
+
+def run(cmd, cwd):
+    # run a program and return (stdout, returncode, wall time [s], peak RSS [KB])
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    polledRSS = 0
+    while proc.poll() is None:
+        try:
+            with open(f'/proc/{proc.pid}/status') as f:
+                match = re.search(r'^VmHWM:\s+(\d+)', f.read(), re.MULTILINE)
+            polledRSS = max(polledRSS, int(match.group(1)))
+        except (OSError, AttributeError):
+            pass
+        time.sleep(0.001)
+    elapsed = time.perf_counter() - start
+    stdout = proc.stdout.read().decode(errors='replace')
+    match = re.search(r'^Peak RSS: (\d+) KB', stdout, re.MULTILINE)
+    return stdout, proc.returncode, elapsed, int(match.group(1)) if match else polledRSS
+
+if __name__ == '__main__':
+    args = read_arguments()
+    if os.path.exists(args.workdir):
+        shutil.rmtree(args.workdir)
+    os.makedirs(os.path.join(args.workdir, 'results'))
+    network = os.path.join(args.workdir, 'Network_ResNet_synthetic.csv')
+    numLayer = write_network(network)
+    designArch = os.path.join(args.workdir, 'designArch.csv')
+
+    numFail = 0
+    for name, cmd in [('arch_generator_for_net', [args.designParam, network, str(args.wbits), str(args.abits), '1', designArch]),
+                      ('main', [designArch, network, str(args.wbits), str(args.abits), '1'])]:
+        stdout, ret, elapsed, peakRSS = run([os.path.join(args.bindir, name)] + cmd, args.workdir)
+        numFail += 1 if ret != 0 else 0
+        print(f"{name:<24} {numLayer} layers  {elapsed:8.3f} s  peak RSS {peakRSS:>8} KB" + ("" if ret == 0 else f"  (exited with {ret})"))
+    sys.exit(1 if numFail > 0 else 0)
@@ -0,0 +1,184 @@
+import argparse
+import os
+import csv
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+# Golden-output regression for full-network runs.
+# Each case in regression/cases.csv goes through arch_generator_for_net and main,
+# and the generated designArch, the chip/hObj breakdowns and the summary metrics
+# are compared against regression/golden/<case>. Wall time and peak RSS of every
+# run are recorded so that performance work can be checked against the same corpus.
+
+summary_names = ["Chip clock period", "Chip leakagePower", "Chip leakageEnergy",
+                 "Energy Efficiency", "Throughput"]
+
+def read_arguments():
+    parser = argparse.ArgumentParser(
+                description = 'run the regression corpus and compare against golden outputs')
+
+    parser.add_argument('--bindir', default='.', type=str)
+    parser.add_argument('--casedir', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), 'regression'), type=str)
+    parser.add_argument('--workdir', default='regression_work', type=str)
+    parser.add_argument('--report', default='', type=str)
+    parser.add_argument('--rtol', default=1e-3, type=float)
+    parser.add_argument('--atol', default=1e-30, type=float)
+    parser.add_argument('--cases', default='', type=str)
+    parser.add_argument('--update', action='store_true')
+    args = parser.parse_args()
+
+    args.bindir = os.path.abspath(args.bindir)
+    args.casedir = os.path.abspath(args.casedir)
+    args.workdir = os.path.abspath(args.workdir)
+    if args.report == '':
+        args.report = os.path.join(args.workdir, 'regression_report.csv')
+
+    return args
+
+def read_cases(args):
+    cases = []
+    with open(os.path.join(args.casedir, 'cases.csv'), newline='') as f:
+        for row in csv.DictReader(f):
+            # optional parameter overrides for arch_generator_for_net/main (space-separated name=value)
+            if row.get('params') is None:
+                row['params'] = ''
+            cases.append(row)
+    if args.cases != '':
+        selected = args.cases.split(',')
+        cases = [case for case in cases if case['name'] in selected]
+    return cases
+
+def run(cmd, cwd):
+    # run a program and return (stdout, returncode, wall time [s], peak RSS [KB])
+    # the peak RSS is reported by the program itself (VmHWM): ru_maxrss of wait4 keeps the RSS of this
+    # interpreter from before the exec, so it cannot measure runs smaller than the interpreter
+    start = time.perf_counter()
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    elapsed = time.perf_counter() - start
+    stdout = proc.stdout.decode(errors='replace')
+    match = re.search(r'^Peak RSS: (\d+) KB', stdout, re.MULTILINE)
+    return stdout, proc.returncode, elapsed, int(match.group(1)) if match else 0
+
+def parse_summary(stdout):
+    summary = []
+    for name in summary_names:
+        match = re.search(r'^' + re.escape(name) + r'\s+([-+0-9.eE]+)', stdout, re.MULTILINE)
+        summary.append([name, match.group(1) if match else 'nan'])
+    return summary
+
+def read_rows(filename):
+    with open(filename, newline='') as f:
+        return [row for row in csv.reader(f) if len(row) > 0]
+
+def is_number(s):
+    try:
+        float(s)
+        return True
+    except ValueError:
+        return False
+
+def compare_rows(name, golden, result, rtol, atol):
+    errors = []
+    if len(golden) != len(result):
+        errors.append(f"{name}: {len(result)} rows (golden {len(golden)})")
+        return errors
+    for rowIdx, (goldenRow, resultRow) in enumerate(zip(golden, result)):
+        if len(goldenRow) != len(resultRow):
+            errors.append(f"{name}[{rowIdx}]: {len(resultRow)} columns (golden {len(goldenRow)})")
+            continue
+        for colIdx, (g, r) in enumerate(zip(goldenRow, resultRow)):
+            if is_number(g) and is_number(r):
+                g, r = float(g), float(r)
+                if abs(g - r) > atol + rtol * abs(g):
+                    errors.append(f"{name}[{rowIdx}][{colIdx}]: {r:.4e} (golden {g:.4e})")
+            elif g != r:
+                errors.append(f"{name}[{rowIdx}][{colIdx}]: {r} (golden {g})")
+    return errors
+
+def run_case(args, case):
+    workdir = os.path.join(args.workdir, case['name'])
+    if os.path.exists(workdir):
+        shutil.rmtree(workdir)
+    os.makedirs(os.path.join(workdir, 'results'))
+
+    designParam = os.path.join(args.casedir, case['designParam'])
+    network = os.path.join(args.casedir, case['network'])
+    designArch = os.path.join(workdir, 'designArch.csv')
+    # files in the parameter overrides are given relative to the case directory ({casedir})
+    params = case['params'].replace('{casedir}', args.casedir).split()
+
+    # generate architecture with design params
+    stdout, ret, archTime, archRSS = run([os.path.join(args.bindir, 'arch_generator_for_net'),
+                                          designParam, network, case['wbits'], case['abits'],
+                                          case['scheduler_type'], designArch] + params, workdir)
+    if ret != 0:
+        return [f"arch_generator_for_net exited with {ret}"], archTime, archRSS, 0, 0
+
+    # simulate generated architecture
+    stdout, ret, mainTime, mainRSS = run([os.path.join(args.bindir, 'main'),
+                                          designArch, network, case['wbits'], case['abits'],
+                                          case['scheduler_type']] + params, workdir)
+    if ret != 0:
+        return [f"main exited with {ret}"], archTime, archRSS, mainTime, mainRSS
+
+    with open(os.path.join(workdir, 'summary.csv'), 'w', newline='') as f:
+        csv.writer(f).writerows(parse_summary(stdout))
+    with open(os.path.join(workdir, 'main.log'), 'w') as f:
+        f.write(stdout)
+
+    outputs = {'designArch.csv': designArch,
+               'performanceChip.csv': os.path.join(workdir, 'results', 'performanceChip.csv'),
+               'performanceHObj.csv': os.path.join(workdir, 'results', 'performanceHObj.csv'),
+               'summary.csv': os.path.join(workdir, 'summary.csv')}
+    # Monte Carlo samples (monteCarlo > 0, fixed monteCarloSeed)
+    monteCarloFile = os.path.join(workdir, 'results', 'monteCarlo.csv')
+    if os.path.exists(monteCarloFile):
+        outputs['monteCarlo.csv'] = monteCarloFile
+
+    goldendir = os.path.join(args.casedir, 'golden', case['name'])
+    errors = []
+    if args.update:
+        os.makedirs(goldendir, exist_ok=True)
+        for name, filename in outputs.items():
+            shutil.copyfile(filename, os.path.join(goldendir, name))
+    else:
+        for name, filename in outputs.items():
+            goldenFile = os.path.join(goldendir, name)
+            if not os.path.exists(goldenFile):
+                errors.append(f"{name}: missing golden file")
+                continue
+            # designArch is an integer architecture description, so it must match exactly
+            rtol = 0 if name == 'designArch.csv' else args.rtol
+            errors += compare_rows(name, read_rows(goldenFile), read_rows(filename), rtol, args.atol)
+
+    return errors, archTime, archRSS, mainTime, mainRSS
+
+def run_regression(args):
+    cases = read_cases(args)
+    os.makedirs(args.workdir, exist_ok=True)
+
+    report = [["case", "status", "arch_time_s", "arch_peak_rss_KB", "main_time_s", "main_peak_rss_KB"]]
+    numFail = 0
+    for case in cases:
+        errors, archTime, archRSS, mainTime, mainRSS = run_case(args, case)
+        status = "FAIL" if errors else ("UPDATED" if args.update else "PASS")
+        numFail += 1 if errors else 0
+        print(f"[{status:>7}] {case['name']:<24} arch {archTime:8.3f} s {archRSS:>8} KB | main {mainTime:8.3f} s {mainRSS:>8} KB")
+        for error in errors[:20]:
+            print(f"          {error}")
+        if len(errors) > 20:
+            print(f"          ... {len(errors)-20} more mismatches")
+        report.append([case['name'], status, f"{archTime:.4f}", archRSS, f"{mainTime:.4f}", mainRSS])
+
+    with open(args.report, "w", newline="") as f:
+        csv.writer(f).writerows(report)
+    print(f"report saved to {args.report}")
+
+    return numFail
+
+if __name__ == '__main__':
+    args = read_arguments()
+    sys.exit(1 if run_regression(args) > 0 else 0)
@@ -0,0 +1,242 @@
+import argparse
+import os
+import csv
+import json
+import shutil
+import socket
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+# Stand-in client of sage_server (line-delimited JSON over a Unix domain socket or the stdin/stdout of the server).
+# With --smoke, the server is started and checked against the golden metrics of regression/cases.csv
+# (cases without parameter overrides), the result and subtree caches against fresh evaluations, and error answers.
+# With --module, the same is checked for the Python extension module (sage_imc) in the bindir, also from a thread pool.
+
+class SageClient:
+    # socket: connect to a running server, otherwise the server is started on pipes (cmd: sage_server arguments)
+    def __init__(self, socket_path='', cmd=None):
+        self.proc = None
+        if socket_path != '':
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            self.sock.connect(socket_path)
+            self.reader = self.sock.makefile('r')
+            self.writer = self.sock.makefile('w')
+        else:
+            self.sock = None
+            self.proc = subprocess.Popen(cmd, stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                         stderr=subprocess.DEVNULL, universal_newlines=True)
+            self.reader = self.proc.stdout
+            self.writer = self.proc.stdin
+        self.nextId = 0
+
+    def request(self, request):
+        self.nextId += 1
+        request = dict(request, id=self.nextId)
+        self.writer.write(json.dumps(request) + '\n')
+        self.writer.flush()
+        line = self.reader.readline()
+        if line == '':
+            raise RuntimeError('sage_server closed the connection')
+        response = json.loads(line)
+        if response.get('id') != self.nextId:
+            raise RuntimeError(f"response to request {response.get('id')} (expected {self.nextId})")
+        return response
+
+    # design_params: rows of (row, col, outType, outBW, inType, inBW, buType, outCoreBW, inCoreBW), hlevel 1 -> top
+    def evaluate(self, design_params, network, **options):
+        return self.request(dict(options, command='evaluate', network=network, designParam=design_params))
+
+    def close(self, shutdown=False):
+        if shutdown:
+            self.request({'command': 'shutdown'})
+        if self.sock is not None:
+            self.sock.close()
+        if self.proc is not None:
+            self.proc.stdin.close()
+            self.proc.wait()
+
+def read_arguments():
+    parser = argparse.ArgumentParser(
+                description = 'client of sage_server (smoke test of the server with --smoke)')
+
+    parser.add_argument('--bindir', default='.', type=str)
+    parser.add_argument('--casedir', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), 'regression'), type=str)
+    parser.add_argument('--workdir', default='sage_server_work', type=str)
+    parser.add_argument('--socket', default='', type=str)   # server to send the request to
+    parser.add_argument('--designParam', default='', type=str)
+    parser.add_argument('--network', default='Network_VGG8.csv', type=str)
+    parser.add_argument('--rtol', default=1e-3, type=float)
+    parser.add_argument('--smoke', action='store_true')
+    parser.add_argument('--module', action='store_true')
+    args = parser.parse_args()
+
+    args.bindir = os.path.abspath(args.bindir)
+    args.casedir = os.path.abspath(args.casedir)
+    args.workdir = os.path.abspath(args.workdir)
+
+    return args
+
+def read_design_params(filename):
+    with open(filename, newline='') as f:
+        return [[int(value) for value in row] for row in csv.reader(f) if len(row) > 0]
+
+def read_golden(casedir, name):
+    with open(os.path.join(casedir, 'golden', name, 'summary.csv'), newline='') as f:
+        summary = {row[0]: float(row[1]) for row in csv.reader(f) if len(row) > 1}
+    return summary['Energy Efficiency'], summary['Throughput']
+
+def start_server(args, socket_path):
+    if os.path.exists(socket_path):
+        os.remove(socket_path)
+    log = open(os.path.join(args.workdir, 'sage_server.log'), 'w')
+    proc = subprocess.Popen([os.path.join(args.bindir, 'sage_server'), '4', '4', '1', '--socket', socket_path],
+                            stdout=log, stderr=subprocess.STDOUT)
+    for _ in range(600):
+        if os.path.exists(socket_path) or proc.poll() is not None:
+            break
+        time.sleep(0.05)
+    if not os.path.exists(socket_path):
+        raise RuntimeError('sage_server did not start (see sage_server.log)')
+    return proc
+
+def close_enough(a, b, rtol):
+    return abs(a - b) <= rtol * abs(b)
+
+# golden cases (the parameter overrides are fixed when the server starts): (name, design params, network, options)
+def read_cases(args):
+    with open(os.path.join(args.casedir, 'cases.csv'), newline='') as f:
+        cases = [case for case in csv.DictReader(f) if (case.get('params') or '') == '']
+    return [(case['name'], read_design_params(os.path.join(args.casedir, case['designParam'])),
+             os.path.join(args.casedir, case['network']),
+             {'wbits': int(case['wbits']), 'abits': int(case['abits']), 'scheduler_type': int(case['scheduler_type'])})
+            for case in cases]
+
+def make_check(errors):
+    def check(condition, message):
+        print(f"[{'PASS' if condition else 'FAIL':>7}] {message}")
+        if not condition:
+            errors.append(message)
+    return check
+
+def run_smoke(args):
+    if os.path.exists(args.workdir):
+        shutil.rmtree(args.workdir)
+    os.makedirs(args.workdir)
+    socket_path = os.path.join(args.workdir, 'sage_server.sock')
+    proc = start_server(args, socket_path)
+    client = SageClient(socket_path)
+    errors = []
+    check = make_check(errors)
+    metrics = ['area', 'energy', 'latency', 'power', 'topsw', 'tops']
+
+    check(client.request({'command': 'ping'})['status'] == 'ok', 'ping')
+
+    responses = {}
+    for name, design_params, network, options in read_cases(args):
+        response = client.evaluate(design_params, network, **options)
+        responses[name] = (design_params, network, options, response)
+        if response['status'] != 'ok':
+            check(False, f"{name}: {response.get('reason')} {response.get('message')}")
+            continue
+        topsw, tops = read_golden(args.casedir, name)
+        check(close_enough(response['topsw'], topsw, args.rtol) and close_enough(response['tops'], tops, args.rtol),
+              f"{name}: {response['topsw']:.4f} TOPS/W {response['tops']:.4f} TOPS (golden {topsw:.4f}, {tops:.4f})")
+
+    # result cache: the same design on the same network
+    design_params, network, options, first = responses['NeuroSim']
+    response = client.evaluate(design_params, network, **options)
+    check(response['cache']['result'] and all(response[m] == first[m] for m in metrics), 'result cache')
+
+    # subtree cache: another top level on the cached lower levels, against a design built from the root only
+    design_params = [row[:] for row in design_params]
+    design_params[-1][7] *= 2
+    warm = client.evaluate(design_params, network, breakdown=True, **options)
+    fresh = client.evaluate(design_params, network, breakdown=True, cache=False, **options)
+    check(warm['cache']['shared'] == len(design_params) - 1 and fresh['cache']['shared'] == 0
+          and all(warm[m] == fresh[m] for m in metrics) and warm['breakdown'] == fresh['breakdown'],
+          f"subtree cache ({warm['cache']['shared']} levels shared)")
+
+    # errors are answered, and the server keeps serving
+    response = client.evaluate([[4, 4, 3, 128]], network)
+    check(response['status'] == 'error' and response['reason'] == 'badRequest', 'malformed request')
+    design_params = [row[:] for row in responses['NeuroSim'][0]]
+    design_params[0][2] = 9
+    response = client.evaluate(design_params, network)
+    check(response['status'] == 'error' and response['reason'] not in ['', 'badRequest'],
+          f"invalid design ({response.get('reason')})")
+
+    stats = client.request({'command': 'stats'})['stats']
+    # a root per CIM array & precision (the mixed-precision network needs its own)
+    check(stats['numRootMiss'] == stats['numRoot'] and stats['numRootHit'] > 0 and stats['numResultHit'] == 1
+          and stats['numSharedObject'] > 0,
+          f"stats {json.dumps(stats)}")
+    client.close(shutdown=True)
+    proc.wait(timeout=60)
+    check(proc.returncode == 0 and not os.path.exists(socket_path), 'shutdown')
+
+    # stdin/stdout of the server
+    client = SageClient(cmd=[os.path.join(args.bindir, 'sage_server'), '4', '4', '1'])
+    design_params, network, options, first = responses['NeuroSim']
+    response = client.evaluate(design_params, network, **options)
+    check(all(response[m] == first[m] for m in metrics), 'stdin server')
+    client.close()
+
+    return len(errors)
+
+def run_module_smoke(args):
+    sys.path.insert(0, args.bindir)
+    import sage_imc
+    errors = []
+    check = make_check(errors)
+    metrics = ['area', 'energy', 'latency', 'power', 'topsw', 'tops']
+
+    results = {}
+    for name, design_params, network, options in read_cases(args):
+        result = sage_imc.evaluate(design_params, network, **options)
+        results[name] = result
+        topsw, tops = read_golden(args.casedir, name)
+        check(close_enough(result['topsw'], topsw, args.rtol) and close_enough(result['tops'], tops, args.rtol)
+              and len(result['latencyBreakdown']) == len(design_params),
+              f"module {name}: {result['topsw']:.4f} TOPS/W {result['tops']:.4f} TOPS (golden {topsw:.4f}, {tops:.4f})")
+
+    # designs evaluated from a thread pool (GIL released) against sequential evaluations
+    _, design_params, network, options = read_cases(args)[0]
+    designs = []
+    for coreBW in [64, 128, 256, 512]:
+        designs.append([row[:] for row in design_params])
+        designs[-1][-1][7] = coreBW
+    sequential = [sage_imc.evaluate(design, network, cache=False, **options) for design in designs]
+    with ThreadPoolExecutor(4) as executor:
+        parallel = list(executor.map(lambda design: sage_imc.evaluate(design, network, cache=False, **options), designs))
+    check(all(s[m] == p[m] for s, p in zip(sequential, parallel) for m in metrics), 'module thread pool')
+
+    # stats/set_param next to running evaluations (simMutex is taken without the GIL, no deadlock)
+    with ThreadPoolExecutor(4) as executor:
+        futures = [executor.submit(sage_imc.evaluate, design, network, cache=False, **options) for design in designs]
+        futures += [executor.submit(sage_imc.stats) for _ in designs]
+        futures.append(executor.submit(sage_imc.set_param, 'clkFreq', 1e9))
+        numDone = len([future.result(timeout=600) for future in futures])
+    check(numDone == 2 * len(designs) + 1, 'module stats/set_param with evaluations')
+
+    design_params = [row[:] for row in design_params]
+    design_params[0][2] = 9
+    try:
+        sage_imc.evaluate(design_params, network, **options)
+        check(False, 'module invalid design')
+    except sage_imc.DesignError as e:
+        check(e.args[0] != '', f"module invalid design ({e.args[0]})")
+
+    return len(errors)
+
+if __name__ == '__main__':
+    args = read_arguments()
+    if args.smoke or args.module:
+        numFail = run_smoke(args) if args.smoke else 0
+        numFail += run_module_smoke(args) if args.module else 0
+        sys.exit(1 if numFail > 0 else 0)
+    # single request to a running server (or a server on pipes)
+    client = SageClient(args.socket, [os.path.join(args.bindir, 'sage_server'), '4', '4', '1'])
+    print(json.dumps(client.evaluate(read_design_params(args.designParam), os.path.abspath(args.network)), indent=1))
+    client.close()
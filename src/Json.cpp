@@ -0,0 +1,326 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include "Json.h"
+
+JsonValue::JsonValue(const vector<double> &values): type(JSON_ARRAY), boolean(false), number(0) {
+    for ( auto value : values ) {
+        array.push_back(JsonValue(value));
+    }
+}
+
+JsonValue::JsonValue(const vector<int> &values): type(JSON_ARRAY), boolean(false), number(0) {
+    for ( auto value : values ) {
+        array.push_back(JsonValue(value));
+    }
+}
+
+/* Parser (recursive descent over the text) */
+class JsonParser {
+public:
+    JsonParser(const string &_text): text(_text), pos(0) {}
+
+    const string &text;
+    size_t pos;
+
+    void Fail(const string &message) {
+        throw runtime_error("malformed JSON at offset " + to_string(pos) + ": " + message);
+    }
+    void SkipSpace() {
+        while ( (pos < text.size()) && ((text[pos] == ' ') || (text[pos] == '\t') || (text[pos] == '\r') || (text[pos] == '\n')) ) {
+            pos++;
+        }
+    }
+    void Expect(char c) {
+        SkipSpace();
+        if ( (pos >= text.size()) || (text[pos] != c) ) {
+            Fail(string("expected '") + c + "'");
+        }
+        pos++;
+    }
+    bool Consume(const string &word) {
+        if ( text.compare(pos, word.size(), word) == 0 ) {
+            pos += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue ParseValue(int depth) {
+        if ( depth > 64 ) {
+            Fail("nested too deep");
+        }
+        SkipSpace();
+        if ( pos >= text.size() ) {
+            Fail("unexpected end");
+        }
+        char c = text[pos];
+        if ( c == '{' ) {
+            pos++;
+            JsonValue value = JsonValue::Object();
+            SkipSpace();
+            if ( (pos < text.size()) && (text[pos] == '}') ) {
+                pos++;
+                return value;
+            }
+            while ( true ) {
+                SkipSpace();
+                if ( (pos >= text.size()) || (text[pos] != '"') ) {
+                    Fail("expected a member name");
+                }
+                string key = ParseString();
+                Expect(':');
+                value.Set(key, ParseValue(depth+1));
+                SkipSpace();
+                if ( (pos < text.size()) && (text[pos] == ',') ) {
+                    pos++;
+                    continue;
+                }
+                Expect('}');
+                return value;
+            }
+        } else if ( c == '[' ) {
+            pos++;
+            JsonValue value = JsonValue::Array();
+            SkipSpace();
+            if ( (pos < text.size()) && (text[pos] == ']') ) {
+                pos++;
+                return value;
+            }
+            while ( true ) {
+                value.Append(ParseValue(depth+1));
+                SkipSpace();
+                if ( (pos < text.size()) && (text[pos] == ',') ) {
+                    pos++;
+                    continue;
+                }
+                Expect(']');
+                return value;
+            }
+        } else if ( c == '"' ) {
+            return JsonValue(ParseString());
+        } else if ( Consume("true") ) {
+            return JsonValue(true);
+        } else if ( Consume("false") ) {
+            return JsonValue(false);
+        } else if ( Consume("null") ) {
+            return JsonValue();
+        }
+        // number
+        const char *begin = text.c_str() + pos;
+        char *end;
+        double number = strtod(begin, &end);
+        if ( (end == begin) || !((c == '-') || ((c >= '0') && (c <= '9'))) ) {
+            Fail("unexpected character");
+        }
+        pos += end - begin;
+        return JsonValue(number);
+    }
+
+    string ParseString() {
+        pos++; // opening quote
+        string str;
+        while ( true ) {
+            if ( pos >= text.size() ) {
+                Fail("unterminated string");
+            }
+            char c = text[pos++];
+            if ( c == '"' ) {
+                return str;
+            } else if ( c != '\\' ) {
+                str += c;
+                continue;
+            }
+            if ( pos >= text.size() ) {
+                Fail("unterminated string");
+            }
+            c = text[pos++];
+            switch ( c ) {
+                case 'n': str += '\n'; break;
+                case 't': str += '\t'; break;
+                case 'r': str += '\r'; break;
+                case 'b': str += '\b'; break;
+                case 'f': str += '\f'; break;
+                case 'u': {
+                    if ( pos + 4 > text.size() ) {
+                        Fail("invalid escape");
+                    }
+                    unsigned code = strtoul(text.substr(pos, 4).c_str(), NULL, 16);
+                    pos += 4;
+                    // UTF-8 of the code point (surrogate pairs are not combined)
+                    if ( code < 0x80 ) {
+                        str += (char)code;
+                    } else if ( code < 0x800 ) {
+                        str += (char)(0xC0 | (code >> 6));
+                        str += (char)(0x80 | (code & 0x3F));
+                    } else {
+                        str += (char)(0xE0 | (code >> 12));
+                        str += (char)(0x80 | ((code >> 6) & 0x3F));
+                        str += (char)(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: str += c; break; // '"', '\\', '/'
+            }
+        }
+    }
+};
+
+JsonValue JsonValue::Parse(const string &text) {
+    JsonParser parser(text);
+    JsonValue value = parser.ParseValue(0);
+    parser.SkipSpace();
+    if ( parser.pos != text.size() ) {
+        parser.Fail("trailing characters");
+    }
+    return value;
+}
+
+static void dumpString(const string &str, string *out) {
+    *out += '"';
+    for ( unsigned char c : str ) {
+        if ( c == '"' ) {
+            *out += "\\\"";
+        } else if ( c == '\\' ) {
+            *out += "\\\\";
+        } else if ( c == '\n' ) {
+            *out += "\\n";
+        } else if ( c == '\t' ) {
+            *out += "\\t";
+        } else if ( c < 0x20 ) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            *out += buf;
+        } else {
+            *out += c;
+        }
+    }
+    *out += '"';
+}
+
+static void dumpValue(const JsonValue &value, string *out) {
+    switch ( value.type ) {
+        case JSON_NULL: *out += "null"; break;
+        case JSON_BOOL: *out += value.boolean? "true" : "false"; break;
+        case JSON_NUMBER: {
+            // NaN/inf have no JSON representation
+            if ( !isfinite(value.number) ) {
+                *out += "null";
+                break;
+            }
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.17g", value.number);
+            *out += buf;
+            break;
+        }
+        case JSON_STRING: dumpString(value.str, out); break;
+        case JSON_ARRAY:
+            *out += '[';
+            for ( int i=0; i < value.array.size(); i++ ) {
+                if ( i > 0 ) { *out += ','; }
+                dumpValue(value.array[i], out);
+            }
+            *out += ']';
+            break;
+        case JSON_OBJECT:
+            *out += '{';
+            for ( int i=0; i < value.object.size(); i++ ) {
+                if ( i > 0 ) { *out += ','; }
+                dumpString(value.object[i].first, out);
+                *out += ':';
+                dumpValue(value.object[i].second, out);
+            }
+            *out += '}';
+            break;
+    }
+}
+
+string JsonValue::Dump() const {
+    string out;
+    dumpValue(*this, &out);
+    return out;
+}
+
+bool JsonValue::Has(const string &key) const {
+    for ( auto &member : object ) {
+        if ( member.first == key ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const JsonValue& JsonValue::Get(const string &key) const {
+    if ( type != JSON_OBJECT ) {
+        throw runtime_error("not an object (member " + key + ")");
+    }
+    for ( auto &member : object ) {
+        if ( member.first == key ) {
+            return member.second;
+        }
+    }
+    throw runtime_error("missing member " + key);
+}
+
+void JsonValue::Set(const string &key, const JsonValue &value) {
+    type = JSON_OBJECT;
+    for ( auto &member : object ) {
+        if ( member.first == key ) {
+            member.second = value;
+            return;
+        }
+    }
+    object.push_back(make_pair(key, value));
+}
+
+bool JsonValue::AsBool() const {
+    if ( type != JSON_BOOL ) {
+        throw runtime_error("not a boolean");
+    }
+    return boolean;
+}
+
+double JsonValue::AsNumber() const {
+    if ( type != JSON_NUMBER ) {
+        throw runtime_error("not a number");
+    }
+    return number;
+}
+
+int JsonValue::AsInt() const {
+    double value = AsNumber();
+    if ( (value != floor(value)) || (fabs(value) > 2147483647.0) ) {
+        throw runtime_error("not an integer");
+    }
+    return (int)value;
+}
+
+const string& JsonValue::AsString() const {
+    if ( type != JSON_STRING ) {
+        throw runtime_error("not a string");
+    }
+    return str;
+}
+
+vector<int> JsonValue::AsIntVector() const {
+    if ( type != JSON_ARRAY ) {
+        throw runtime_error("not an array");
+    }
+    vector<int> values;
+    for ( auto &value : array ) {
+        values.push_back(value.AsInt());
+    }
+    return values;
+}
+
+vector<vector<int>> JsonValue::AsIntVector2() const {
+    if ( type != JSON_ARRAY ) {
+        throw runtime_error("not an array");
+    }
+    vector<vector<int>> values;
+    for ( auto &value : array ) {
+        values.push_back(value.AsIntVector());
+    }
+    return values;
+}
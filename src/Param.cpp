@@ -43,6 +43,7 @@
 #include <fstream>
 #include <string>
 #include <stdlib.h>
+#include "util.h"
 #include <vector>
 #include <sstream>
 #include <chrono>
@@ -104,6 +105,20 @@ Param::Param() {
 	
 	pipeline = false;            // false: layer-by-layer process --> huge leakage energy in HP
 								// true: pipeline process
+	batchSize = 1;               // number of images per inference batch (overlapped in pipeline process)
+	topBufferImage = 1;          // number of images whose feature maps the top-level buffer is sized for (arch_generator_for_net)
+	replicaBudget = 0;           // extra top-level subObjects for weight replication (ratio to the subObjects used w/o replication, compact mapping)
+	meshModel = 0;               // 2D Mesh NoC latency, 0: analytical (hops x numRead), 1: event-driven (XY routing & link contention)
+	meshBufferDepth = 4;         // #flits of the router input buffer (event-driven 2D Mesh NoC)
+	powerGating = 0;             // 1: units (of powerGatingLevel) idle in a layer are power gated in the leakage
+	powerGatingLevel = 0;        // hlevel of the gated unit, 0: array, 1: first-level hObject (PE), 2: second-level hObject (tile), ...
+	powerGatingWakeUp = 10;      // wake-up overhead of a gated unit (energy of its leakage for the given cycles)
+	monteCarlo = 0;              // #samples of the Monte Carlo device variation (0: off)
+	monteCarloSeed = 0;          // seed of the Monte Carlo samples
+	sigmaResistance = 0.1;       // device-to-device variation of Ron/Roff (sigma of lognormal)
+	readNoise = 0.05;            // read noise of the column current (relative sigma, Monte Carlo only)
+	pingPongBuffer = 0;          // 1: BufferUnit with two banks (ping-pong), writes of the next tile overlap with reads
+	inputOverlap = 0;            // 1: input feeding of the next subObjects is overlapped with the computation (double buffering)
 	speedUpDegree = 8;          // 1 = no speed up --> original speed
 								// 2 and more : speed up ratio, the higher, the faster
 								// A speed-up degree upper bound: when there is no idle period during each layer --> no need to further fold the system clock
@@ -269,3 +284,79 @@ Param::Param() {
 	/***************************************** Initialization of parameters NO need to modify *****************************************/
 }
 
+/* Override parameters with command line arguments (name=value) */
+void Param::ReadParamArgs(int argc, char *argv[], int firstArg) {
+    for (int argIdx=firstArg; argIdx < argc; argIdx++) {
+        string arg = argv[argIdx];
+        size_t pos = arg.find('=');
+        if ( (pos != string::npos) && (arg.substr(0, pos) == "activityProfile") ) { // file parameter
+            ReadActivityProfile(arg.substr(pos+1));
+        } else if ( (pos == string::npos) || !SetParam(arg.substr(0, pos), atof(arg.substr(pos+1).c_str())) ) {
+            cerr << "[Error] invalid parameter argument: " << arg << endl;
+            exit(-1);
+        }
+        paramArgs.push_back(arg);
+        printf("Parameter override: %s\n", arg.c_str());
+    }
+}
+
+/* Read input activity profile (csv, a row per layer with the active ratio of each input bitplane) */
+void Param::ReadActivityProfile(const string &filename) {
+    activityProfile = readCSV(filename);
+    for ( auto &layerProfile : activityProfile ) {
+        for ( auto ratio : layerProfile ) {
+            if ( (ratio <= 0) || (ratio > 1) ) {
+                cerr << "[Error] input active ratio of the activity profile should be in (0, 1]" << endl;
+                exit(-1);
+            }
+        }
+    }
+}
+
+/* Set parameter by name, return false for unknown parameter */
+bool Param::SetParam(const string &name, double value) {
+    if ( name == "pipeline" ) {
+        pipeline = ( value != 0 );
+    } else if ( (name == "batchSize") && (value >= 1) ) {
+        batchSize = (int)value;
+    } else if ( (name == "topBufferImage") && (value >= 1) ) {
+        topBufferImage = (int)value;
+    } else if ( (name == "replicaBudget") && (value >= 0) ) {
+        replicaBudget = value;
+    } else if ( name == "meshModel" ) {
+        meshModel = (int)value;
+    } else if ( (name == "meshBufferDepth") && (value >= 1) ) {
+        meshBufferDepth = (int)value;
+    } else if ( name == "powerGating" ) {
+        powerGating = (int)value;
+    } else if ( name == "powerGatingLevel" ) {
+        powerGatingLevel = (int)value;
+    } else if ( (name == "powerGatingWakeUp") && (value >= 0) ) {
+        powerGatingWakeUp = value;
+    } else if ( name == "pingPongBuffer" ) {
+        pingPongBuffer = (int)value;
+    } else if ( name == "inputOverlap" ) {
+        inputOverlap = (int)value;
+    } else if ( (name == "numRowCIMArray") && (value >= 1) ) {
+        numRowCIMArray = (int)value;
+    } else if ( (name == "numColCIMArray") && (value >= 1) ) {
+        numColCIMArray = (int)value;
+    } else if ( (name == "levelOutput") && (value >= 2) ) {
+        levelOutput = (int)value;
+    } else if ( (name == "numColMuxed") && (value >= 1) ) {
+        numColMuxed = (int)value;
+    } else if ( (name == "clkFreq") && (value > 0) ) {
+        clkFreq = value;
+    } else if ( (name == "monteCarlo") && (value >= 0) ) {
+        monteCarlo = (int)value;
+    } else if ( name == "monteCarloSeed" ) {
+        monteCarloSeed = (int)value;
+    } else if ( (name == "sigmaResistance") && (value >= 0) ) {
+        sigmaResistance = value;
+    } else if ( (name == "readNoise") && (value >= 0) ) {
+        readNoise = value;
+    } else {
+        return false;
+    }
+    return true;
+}
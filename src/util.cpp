@@ -3,6 +3,7 @@
 #include <string>
 #include <iostream>
 #include <unistd.h>
+#include <sys/resource.h>
 
 vector<vector<double>> readCSV(const string &inputfile) {
     ifstream infile(inputfile.c_str());
@@ -515,3 +516,75 @@ vector<vector<double>> updateAreaVector2(const vector<vector<double>> *areaVecto
     }
     return newAreaVector;
 }
+
+void readNetworkList(const string &networkList, vector<string> *networkFiles, vector<double> *networkWeights) {
+    networkFiles->clear();
+    networkWeights->clear();
+    istringstream iss(networkList);
+    string item;
+    while (getline(iss, item, ',')) {
+        if ( item.empty() ) { continue; }
+        size_t pos = item.rfind(':');
+        double weight = 1;
+        if ( pos != string::npos ) {
+            weight = atof(item.substr(pos+1).c_str());
+            item = item.substr(0, pos);
+        }
+        if ( weight <= 0 ) {
+            cerr << "[Error] weight of network [" << item << "] should be positive" << endl;
+            exit(-1);
+        }
+        networkFiles->push_back(item);
+        networkWeights->push_back(weight);
+    }
+    if ( networkFiles->size() == 0 ) {
+        cerr << "[Error] no network is given" << endl;
+        exit(-1);
+    }
+}
+
+string getNetworkName(const string &networkFile) {
+    string name = networkFile.substr(networkFile.find_last_of('/') + 1);
+    size_t pos = name.rfind(".csv");
+    return ( pos != string::npos )? name.substr(0, pos) : name;
+}
+
+long getPeakRSS() {
+    // VmHWM belongs to the address space of this program (ru_maxrss also keeps the peak of the parent before exec)
+    ifstream fin("/proc/self/status");
+    string line;
+    while ( getline(fin, line) ) {
+        if ( line.compare(0, 6, "VmHWM:") == 0 ) {
+            return atol(line.substr(6).c_str());
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void savePortfolioMetric(int archIdx, const string &filename, int numHierarchy,
+                        const string &network, double weight, const vector<double> &metrics) {
+    // check if the file already exist
+    bool fileExist = ( access(filename.c_str(), F_OK) != -1 );
+
+    // open csv file
+    fstream fout;
+    fout.open(filename, ios::out | ios::app);
+
+    // write header if neccesary
+    if ( !fileExist ) {
+        fout << "archIdx,numHierarchy,network,weight,energy_with_leakage,latency,topsw,tops\n";
+    }
+
+    // write indicator (archIdx, numHierarchy, network)
+    fout << archIdx << "," << numHierarchy << "," << network << "," << weight;
+
+    // write metrics
+    char charPerformance[15];
+    for ( auto metric : metrics ) {
+        sprintf(charPerformance, "%.4e", metric);
+        fout << "," << charPerformance;
+    }
+    fout << "\n";
+}